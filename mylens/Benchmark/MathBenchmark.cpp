@@ -0,0 +1,643 @@
+/**
+ * @file    MathBenchmark.cpp
+ * @brief   Micro-benchmarks of the header-only My::Math module: generation and evaluation of
+ *          every spline type over 8 to 10^6 knots, the spline arithmetic, knot gradients by Dual
+ *          numbers (checked against central differences) and SimplexSolver (also flat) on
+ *          standard test functions. Reports ns/op, heap allocations/op and the scaling exponent
+ *          between consecutive sizes, as a table, CSV or JSON (for regression tracking).
+ *
+ * Standalone, it is not part of the UWP project. Build on Linux from the repository root:
+ *
+ *      g++ -std=c++17 -O3 -march=native -pthread -I mylens/Include/My \
+ *          mylens/Benchmark/MathBenchmark.cpp -o math_benchmark
+ *
+ * Usage:
+ *
+ *      math_benchmark [--csv | --json] [--float] [--filter <text>] [--max-knots <n>]
+ *                     [--min-time <seconds>]
+ *
+ * @author  Ronja Schnur (rschnur@students.uni-mainz.de)
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Math/CompiledSpline.h"
+#include "Math/CubicSpline.h"
+#include "Math/CurvatureSpline.h"
+#include "Math/Dual.h"
+#include "Math/FixedQuadraticSpline.h"
+#include "Math/GradientSpline.h"
+#include "Math/QuadraticSpline.h"
+#include "Math/SimplexSolver.h"
+#include "Math/SplineBank.h"
+
+// Allocation counting //
+
+namespace
+{
+std::atomic<size_t> allocations{0};
+}
+
+void * operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void * p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void * operator new(std::size_t size, std::align_val_t alignment)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    size_t a{size_t(alignment)};
+    if (void * p = std::aligned_alloc(a, (size + a - 1) / a * a)) return p;
+    throw std::bad_alloc();
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete(void * p) noexcept { std::free(p); }
+void operator delete(void * p, std::size_t) noexcept { std::free(p); }
+void operator delete(void * p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void * p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+namespace
+{
+
+using namespace My::Math;
+
+// Harness //
+
+struct Options
+{
+    enum class Format
+    {
+        Table,
+        CSV,
+        JSON
+    } format{Format::Table};
+
+    bool single{false}; // float instead of double
+    std::string filter;
+    size_t max_knots{1000000};
+    double min_time{0.1};
+};
+
+struct Result
+{
+    std::string group, name;
+    size_t size;
+    double ns_per_op, allocs_per_op, exponent; // exponent is NAN for the first size
+    size_t iterations;
+};
+
+volatile double sink; // keeps results alive
+
+class Suite
+{
+    // Data //
+private:
+    const Options & _options;
+    std::vector<Result> _results;
+
+    // Constructors //
+public:
+    explicit Suite(const Options & options) : _options{options} {}
+
+    // Methods //
+public:
+    /**
+     * @brief   Runs f until min_time passed (doubling the repetitions), f performs ops operations
+     *          per call.
+     */
+    void run(const std::string & group, const std::string & name, size_t size, size_t ops,
+             const std::function<void()> & f)
+    {
+        if (!_options.filter.empty() &&
+            (group + "/" + name).find(_options.filter) == std::string::npos)
+            return;
+
+        using clock = std::chrono::steady_clock;
+        f(); // warm up caches and scratch buffers
+
+        size_t iterations{1};
+        double seconds{0};
+        size_t count{0};
+        while (true)
+        {
+            count = allocations.load();
+            auto start = clock::now();
+            for (size_t i = 0; i < iterations; ++i) f();
+            seconds = std::chrono::duration<double>(clock::now() - start).count();
+            count = allocations.load() - count;
+            if (seconds >= _options.min_time || iterations >= (size_t(1) << 30)) break;
+            iterations *= 2;
+        }
+
+        double total{double(iterations) * double(ops)};
+        Result r{group, name, size, seconds * 1e9 / total, double(count) / total, NAN, iterations};
+        for (auto it = _results.rbegin(); it != _results.rend(); ++it)
+            if (it->group == group && it->name == name)
+            {
+                r.exponent = std::log(r.ns_per_op / it->ns_per_op) /
+                             std::log(double(size) / double(it->size));
+                break;
+            }
+
+        _results.push_back(r);
+        if (_options.format == Options::Format::Table) print(r);
+    }
+
+    void header() const
+    {
+        if (_options.format == Options::Format::Table)
+            std::printf("%-14s %-28s %9s %14s %12s %9s\n", "group", "benchmark", "size", "ns/op",
+                        "allocs/op", "scaling");
+        else if (_options.format == Options::Format::CSV)
+            std::printf("group,name,size,ns_per_op,allocs_per_op,exponent,iterations\n");
+    }
+
+    void footer() const
+    {
+        if (_options.format == Options::Format::CSV)
+            for (const auto & r : _results)
+                std::printf("%s,%s,%zu,%.3f,%.4f,%.3f,%zu\n", r.group.c_str(), r.name.c_str(),
+                            r.size, r.ns_per_op, r.allocs_per_op, r.exponent, r.iterations);
+        else if (_options.format == Options::Format::JSON)
+        {
+            std::printf("{\n  \"value_type\": \"%s\",\n  \"results\": [\n",
+                        _options.single ? "float" : "double");
+            for (size_t i = 0; i < _results.size(); ++i)
+            {
+                const auto & r{_results[i]};
+                std::printf("    {\"group\": \"%s\", \"name\": \"%s\", \"size\": %zu, "
+                            "\"ns_per_op\": %.3f, \"allocs_per_op\": %.4f, \"exponent\": ",
+                            r.group.c_str(), r.name.c_str(), r.size, r.ns_per_op,
+                            r.allocs_per_op);
+                if (std::isnan(r.exponent))
+                    std::printf("null");
+                else
+                    std::printf("%.3f", r.exponent);
+                std::printf(", \"iterations\": %zu}%s\n", r.iterations,
+                            i + 1 < _results.size() ? "," : "");
+            }
+            std::printf("  ]\n}\n");
+        }
+    }
+
+private:
+    void print(const Result & r) const
+    {
+        std::printf("%-14s %-28s %9zu %14.2f %12.3f ", r.group.c_str(), r.name.c_str(), r.size,
+                    r.ns_per_op, r.allocs_per_op);
+        if (std::isnan(r.exponent))
+            std::printf("%9s\n", "-");
+        else
+            std::printf("%9.2f\n", r.exponent);
+        std::fflush(stdout);
+    }
+};
+
+// Splines //
+
+constexpr size_t num_lookups = 1024;
+
+template <typename value_t> struct Data
+{
+    std::vector<value_t> x, y, lookups;
+
+    /**
+     * @brief   n knots on [0, 1], jittered if non-uniform, and num_lookups random positions.
+     */
+    Data(size_t n, bool uniform)
+    {
+        std::mt19937 random{42};
+        std::uniform_real_distribution<double> unit{0, 1};
+        double h{1.0 / double(n - 1)};
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            double jitter{uniform || i == 0 || i == n - 1 ? 0 : (unit(random) - 0.5) * 0.8 * h};
+            x.push_back(value_t(double(i) * h + jitter));
+            y.push_back(value_t(std::sin(6.0 * double(i) * h) + 0.1 * unit(random)));
+        }
+        for (size_t i = 0; i < num_lookups; ++i) lookups.push_back(value_t(unit(random)));
+    }
+};
+
+/**
+ * @brief   generate() and single/batched compute() of a spline with the Spline interface.
+ */
+template <typename value_t, typename spline_t>
+void evaluation(Suite & suite, const std::string & group, const std::string & kind,
+                spline_t & spline, const Data<value_t> & data, size_t n)
+{
+    suite.run(group, "generate/" + kind, n, 1, [&]() {
+        spline.generate();
+        sink = double(spline.polynomData()[0]);
+    });
+    spline.generate();
+
+    suite.run(group, "compute/" + kind, n, num_lookups, [&]() {
+        value_t s{0};
+        for (value_t x : data.lookups) s += spline.compute(x);
+        sink = double(s);
+    });
+}
+
+template <typename value_t> void quadratic(Suite & suite, size_t n, bool uniform)
+{
+    Data<value_t> data{n, uniform};
+    std::string kind{uniform ? "uniform" : "non-uniform"};
+
+    auto spline{uniform ? QuadraticSpline<value_t>(n, {value_t(0), value_t(1)})
+                        : QuadraticSpline<value_t>(data.x, data.y)};
+    for (size_t i = 0; i < n; ++i) spline.specify(i, data.y[i]);
+    evaluation(suite, "Quadratic", kind, spline, data, n);
+
+    std::vector<value_t> out(num_lookups);
+    suite.run("Quadratic", "compute-batch/" + kind, n, num_lookups, [&]() {
+        spline.compute(data.lookups.data(), out.data(), num_lookups);
+        sink = double(out[0]);
+    });
+
+    suite.run("Quadratic", "update-last/" + kind, n, 1, [&]() {
+        spline.specify(n - 1, spline.Y()[n - 1] + value_t(1e-3));
+        spline.update();
+    });
+
+    auto compiled{spline.compile()};
+    suite.run("Compiled", "evaluate/" + kind, n, num_lookups, [&]() {
+        value_t s{0};
+        for (value_t x : data.lookups) s += compiled->evaluate(x);
+        sink = double(s);
+    });
+    suite.run("Compiled", "compile/" + kind, n, 1,
+              [&]() { sink = double(spline.compile()->evaluate(0)); });
+}
+
+template <typename value_t> void gradient(Suite & suite, size_t n, bool uniform)
+{
+    Data<value_t> data{n, uniform};
+    GradientSpline<value_t> spline(n - 2, {value_t(0), value_t(1)}, data.y[0], data.y[n - 1]);
+    for (size_t i = 1; i < n - 1; ++i) spline.specify(i, data.y[i]);
+    if (!uniform)
+        for (size_t i = 1; i < n - 1; ++i) spline.specifyX(i, data.x[i]);
+    evaluation(suite, "Gradient", uniform ? "uniform" : "non-uniform", spline, data, n);
+}
+
+template <typename value_t> void curvature(Suite & suite, size_t n)
+{
+    Data<value_t> data{n, true};
+    CurvatureSpline<value_t> spline(n - 1, value_t(0), value_t(1), {value_t(0), value_t(1)});
+    for (size_t i = 0; i < n - 1; ++i) spline.curvature(i, value_t(1) + data.y[i] * data.y[i]);
+    evaluation(suite, "Curvature", "uniform", spline, data, n);
+}
+
+template <typename value_t> void cubic(Suite & suite, size_t n, bool uniform)
+{
+    Data<value_t> data{n, uniform};
+    auto spline{uniform ? CubicSpline<value_t>(n, {value_t(0), value_t(1)})
+                        : CubicSpline<value_t>(data.x, data.y)};
+    for (size_t i = 0; i < n; ++i) spline.specify(i, data.y[i]);
+    evaluation(suite, "Cubic", uniform ? "uniform" : "non-uniform", spline, data, n);
+}
+
+template <typename value_t> void bank(Suite & suite, size_t n)
+{
+    constexpr size_t count = 8;
+    Data<value_t> data{n, true};
+    SplineBank<value_t> splines(count, n, {value_t(0), value_t(1)},
+                                SplineBank<value_t>::Kind::Quadratic);
+    for (size_t s = 0; s < count; ++s)
+        for (size_t i = 0; i < n; ++i) splines.specify(s, i, data.y[i] + value_t(s));
+
+    suite.run("Bank", "generate/8-splines", n, 1, [&]() { splines.generate(); });
+    splines.generate();
+
+    value_t out[count];
+    suite.run("Bank", "compute/8-splines", n, num_lookups, [&]() {
+        for (value_t x : data.lookups) splines.compute(x, out);
+        sink = double(out[0]);
+    });
+}
+
+template <typename value_t, size_t N> void fixed(Suite & suite)
+{
+    Data<value_t> data{N, true};
+    FixedQuadraticSpline<value_t, N> spline({value_t(0), value_t(1)});
+    for (size_t i = 0; i < N; ++i) spline.specify(i, data.y[i]);
+
+    suite.run("Fixed", "generate/uniform", N, 1, [&]() {
+        spline.generate();
+        sink = double(spline.evaluate(0));
+    });
+    suite.run("Fixed", "compute/uniform", N, num_lookups, [&]() {
+        value_t s{0};
+        for (value_t x : data.lookups) s += spline.evaluate(x);
+        sink = double(s);
+    });
+}
+
+template <typename value_t> void arithmetic(Suite & suite, size_t n)
+{
+    Data<value_t> data{n, true};
+    std::shared_ptr<Spline<value_t>> a{
+        std::make_shared<QuadraticSpline<value_t>>(n, Intervall<value_t>{0, 1})},
+        b{a->copy()};
+    for (size_t i = 0; i < n; ++i) b->specify(i, data.y[i]);
+
+    suite.run("Arithmetic", "a += b", n, 1, [&]() { *a += *b; });
+    suite.run("Arithmetic", "a *= s", n, 1, [&]() { *a *= value_t(0.5); });
+    suite.run("Arithmetic", "a.assign(s, a, t, b)", n, 1,
+              [&]() { a->assign(value_t(0.5), *a, value_t(0.25), *b); });
+    suite.run("Arithmetic", "a + b (copy)", n, 1, [&]() { sink = double((a + b)->Y()[0]); });
+}
+
+/**
+ * @brief   Jacobian of the values at the lookups with respect to the y-knots, by Dual numbers
+ *          and by central differences. Reports on stderr if they disagree.
+ */
+template <typename value_t> void dual(Suite & suite, size_t n)
+{
+    constexpr size_t N = 16;
+    using dual_t = Dual<value_t, N>;
+    Data<value_t> data{n, true};
+    auto set = [](auto & s, size_t j, auto v) { s.specify(j, v); };
+
+    QuadraticSpline<dual_t> d(n, {dual_t(0), dual_t(1)});
+    std::vector<value_t> values(num_lookups), jacobian(num_lookups * n);
+    suite.run("Dual", "jacobian/forward", n, 1, [&]() {
+        valuesAndJacobian(d, n, set, data.y.data(), data.lookups.data(), num_lookups,
+                          values.data(), jacobian.data());
+        sink = double(jacobian[0]);
+    });
+
+    QuadraticSpline<value_t> s(n, {value_t(0), value_t(1)});
+    for (size_t i = 0; i < n; ++i) s.specify(i, data.y[i]);
+    std::vector<value_t> differences(num_lookups * n), plus(num_lookups), minus(num_lookups);
+    // the spline is linear in its knots, a large step only reduces the rounding
+    constexpr bool single{std::is_same_v<value_t, float>};
+    value_t h{single ? value_t(1e-1) : value_t(1e-3)};
+    suite.run("Dual", "jacobian/central-differences", n, 1, [&]() {
+        for (size_t j = 0; j < n; ++j)
+        {
+            s.specify(j, data.y[j] + h);
+            s.compute(data.lookups.data(), plus.data(), num_lookups);
+            s.specify(j, data.y[j] - h);
+            s.compute(data.lookups.data(), minus.data(), num_lookups);
+            s.specify(j, data.y[j]);
+            for (size_t i = 0; i < num_lookups; ++i)
+                differences[i * n + j] = (plus[i] - minus[i]) / (2 * h);
+        }
+        sink = double(differences[0]);
+    });
+
+    double error{0};
+    for (size_t k = 0; k < jacobian.size(); ++k)
+        error = std::max(error, std::abs(double(jacobian[k] - differences[k])));
+    if (!(error < (single ? 1e-2 : 1e-8)))
+        std::fprintf(stderr, "Dual: jacobian of %zu knots deviates by %g\n", n, error);
+}
+
+template <typename value_t> void splines(Suite & suite, const Options & options)
+{
+    std::vector<size_t> sizes;
+    for (size_t n = 8; n < options.max_knots; n *= 8) sizes.push_back(n);
+    sizes.push_back(options.max_knots);
+
+    for (bool uniform : {true, false})
+        for (size_t n : sizes) quadratic<value_t>(suite, n, uniform);
+    for (bool uniform : {true, false})
+        for (size_t n : sizes) gradient<value_t>(suite, n, uniform);
+    for (size_t n : sizes) curvature<value_t>(suite, n);
+    for (bool uniform : {true, false})
+        for (size_t n : sizes) cubic<value_t>(suite, n, uniform);
+    for (size_t n : sizes)
+        if (n <= 262144) bank<value_t>(suite, n); // 8 splines of 10^6 knots do not fit in cache
+    fixed<value_t, 8>(suite);
+    fixed<value_t, 64>(suite);
+    fixed<value_t, 512>(suite);
+    for (size_t n : sizes) arithmetic<value_t>(suite, n);
+    for (size_t n : sizes)
+        if (n <= 64) dual<value_t>(suite, n); // the Jacobian has num_lookups x n entries
+}
+
+// Simplex //
+
+template <typename value_t> class VectorArgument : public SimplexFunctionArgument<value_t>
+{
+    // Data //
+public:
+    std::vector<value_t> _x;
+
+    // Constructors //
+public:
+    explicit VectorArgument(std::vector<value_t> x)
+        : SimplexFunctionArgument<value_t>(x.size()), _x{std::move(x)}
+    {}
+
+    // Methods //
+private:
+    std::shared_ptr<SimplexFunctionArgument<value_t>>
+    make(const std::function<value_t(size_t)> & f) const
+    {
+        std::vector<value_t> r(_x.size());
+        for (size_t i = 0; i < r.size(); ++i) r[i] = f(i);
+        return std::make_shared<VectorArgument>(std::move(r));
+    }
+
+    static const std::vector<value_t> &
+    of(const std::shared_ptr<SimplexFunctionArgument<value_t>> & o)
+    {
+        return static_cast<VectorArgument &>(*o)._x;
+    }
+
+public:
+    value_t get(size_t i) override { return _x[i]; }
+
+    void set(size_t i, value_t v) override { _x[i] = v; }
+
+    std::shared_ptr<SimplexFunctionArgument<value_t>>
+    add(std::shared_ptr<SimplexFunctionArgument<value_t>> o) override
+    {
+        return make([&](size_t i) { return _x[i] + of(o)[i]; });
+    }
+
+    std::shared_ptr<SimplexFunctionArgument<value_t>>
+    sub(std::shared_ptr<SimplexFunctionArgument<value_t>> o) override
+    {
+        return make([&](size_t i) { return _x[i] - of(o)[i]; });
+    }
+
+    std::shared_ptr<SimplexFunctionArgument<value_t>> div(value_t o) override
+    {
+        return make([&](size_t i) { return _x[i] / o; });
+    }
+
+    std::shared_ptr<SimplexFunctionArgument<value_t>> mul(value_t o) override
+    {
+        return make([&](size_t i) { return _x[i] * o; });
+    }
+
+    std::shared_ptr<SimplexFunctionArgument<value_t>> copy() override
+    {
+        return std::make_shared<VectorArgument>(_x);
+    }
+};
+
+template <typename value_t> class TestFunction : public SimplexFunction<value_t>
+{
+    // Data //
+private:
+    std::function<value_t(Span<const value_t>)> _f;
+
+    // Constructors //
+public:
+    explicit TestFunction(std::function<value_t(Span<const value_t>)> f) : _f{std::move(f)} {}
+
+    // Methods //
+public:
+    value_t compute(const std::shared_ptr<SimplexFunctionArgument<value_t>> & t) override
+    {
+        return _f(static_cast<VectorArgument<value_t> &>(*t)._x);
+    }
+};
+
+template <typename value_t> class FlatTestFunction : public FlatSimplexFunction<value_t>
+{
+    // Data //
+private:
+    std::function<value_t(Span<const value_t>)> _f;
+
+    // Constructors //
+public:
+    explicit FlatTestFunction(std::function<value_t(Span<const value_t>)> f) : _f{std::move(f)}
+    {}
+
+    // Methods //
+public:
+    value_t compute(Span<const value_t> x) override { return _f(x); }
+};
+
+template <typename value_t> void simplex(Suite & suite)
+{
+    using vector_t = std::vector<value_t>;
+    struct Problem
+    {
+        std::string name;
+        std::function<value_t(Span<const value_t>)> f;
+        value_t start;
+    };
+
+    std::vector<Problem> problems{
+        {"sphere",
+         [](Span<const value_t> x) {
+             value_t s{0};
+             for (value_t v : x) s += (v - 1) * (v - 1);
+             return s;
+         },
+         value_t(-1)},
+        {"rosenbrock",
+         [](Span<const value_t> x) {
+             value_t s{0};
+             for (size_t i = 0; i + 1 < x.size(); ++i)
+                 s += 100 * (x[i + 1] - x[i] * x[i]) * (x[i + 1] - x[i] * x[i]) +
+                      (1 - x[i]) * (1 - x[i]);
+             return s;
+         },
+         value_t(-1.2)},
+        {"rastrigin",
+         [](Span<const value_t> x) {
+             value_t s{value_t(10) * value_t(x.size())};
+             for (value_t v : x) s += v * v - 10 * std::cos(value_t(2 * 3.14159265358979) * v);
+             return s;
+         },
+         value_t(0.3)},
+    };
+
+    for (const auto & problem : problems)
+        for (size_t n : {2, 4, 8})
+        {
+            // asymmetric start, a symmetric one gives equal values and stops at once
+            vector_t x(n);
+            for (size_t i = 0; i < n; ++i) x[i] = problem.start + value_t(0.1) * value_t(i);
+            value_t tolerance{std::is_same_v<value_t, float> ? value_t(1e-6) : value_t(1e-10)};
+
+            auto function{std::make_shared<TestFunction<value_t>>(problem.f)};
+            suite.run("Simplex", "solve/" + problem.name, n, 1, [&]() {
+                auto start{std::make_shared<VectorArgument<value_t>>(x)};
+                SimplexSolver<value_t> solver(function, start, value_t(0.5), tolerance);
+                sink = double(solver.solve(false)._second);
+            });
+            suite.run("Simplex", "solve-adapter/" + problem.name, n, 1, [&]() {
+                auto start{std::make_shared<VectorArgument<value_t>>(x)};
+                SimplexSolver<value_t> solver(function, start, value_t(0.5), tolerance);
+                sink = double(solver.solveFlat(false)._second);
+            });
+
+            FlatSimplexSolver<value_t> flat(std::make_shared<FlatTestFunction<value_t>>(problem.f),
+                                            x, value_t(0.5), tolerance);
+            suite.run("Simplex", "solve-flat/" + problem.name, n, 1,
+                      [&]() { sink = double(flat.solve()); });
+        }
+}
+
+template <typename value_t> void all(const Options & options)
+{
+    Suite suite{options};
+    suite.header();
+    splines<value_t>(suite, options);
+    simplex<value_t>(suite);
+    suite.footer();
+}
+
+} // namespace
+
+int main(int argc, char ** argv)
+{
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg{argv[i]};
+        bool value{i + 1 < argc};
+        if (arg == "--csv")
+            options.format = Options::Format::CSV;
+        else if (arg == "--json")
+            options.format = Options::Format::JSON;
+        else if (arg == "--float")
+            options.single = true;
+        else if (arg == "--filter" && value)
+            options.filter = argv[++i];
+        else if (arg == "--max-knots" && value)
+            options.max_knots = std::max<size_t>(8, std::strtoull(argv[++i], nullptr, 10));
+        else if (arg == "--min-time" && value)
+            options.min_time = std::strtod(argv[++i], nullptr);
+        else
+        {
+            std::fprintf(stderr,
+                         "usage: %s [--csv | --json] [--float] [--filter <text>] "
+                         "[--max-knots <n>] [--min-time <seconds>]\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+
+    if (options.single)
+        all<float>(options);
+    else
+        all<double>(options);
+    return 0;
+}
@@ -0,0 +1,281 @@
+#pragma once
+
+#include "pch.h"
+
+#include "Eye/Object.h"
+
+namespace My::Eye
+{
+
+namespace _implementation
+{
+
+using namespace DirectX;
+
+/**
+ * @brief   Finds the segment [times[i], times[i + 1]) containing time. Time is clamped to the
+ *          keys first, so tracks hold their first and last key.
+ */
+inline size_t track_segment(const std::vector<float> & times, float & time)
+{
+    time = (std::min)((std::max)(time, times.front()), times.back());
+    size_t i = size_t(std::upper_bound(times.begin(), times.end(), time) - times.begin());
+    return (std::min)((std::max)(i, size_t(1)), times.size() - 1) - 1;
+}
+
+/**
+ * @brief   Vector valued quadratic spline through position keys (the construction of
+ *          My::Math::QuadraticSpline applied to x, y and z at once).
+ *
+ * The coefficients of each segment are stored as a packed XMVECTOR triple (a, b, c) relative
+ * to the segment's first key, p(t) = (a t + b) t + c, so evaluating xyz is two vector
+ * multiply-adds.
+ *
+ * @ingroup Eye
+ * @author  Ronja Schnur (rschnur@students.uni-mainz.de)
+ */
+class PositionTrack
+{
+    // Data //
+private:
+    std::vector<float> _times;
+    std::vector<XMVECTOR> _keys;
+    std::vector<XMVECTOR> _polynom; // a_0, b_0, c_0, a_1, ...
+    bool _dirty{true};
+
+    // Properties //
+public:
+    size_t size() const { return _keys.size(); }
+
+    float time(size_t i) const { return _times[i]; }
+
+    XMVECTOR key(size_t i) const { return _keys[i]; }
+
+    void key(size_t i, const XMVECTOR & position_v)
+    {
+        _keys[i] = position_v;
+        _dirty = true;
+    }
+
+    // Constructors //
+public:
+    /**
+     * @param   times   Strictly increasing key times (at least two).
+     * @param   keys    The positions at the key times.
+     */
+    PositionTrack(std::vector<float> times, std::vector<XMVECTOR> keys)
+        : _times{std::move(times)}, _keys{std::move(keys)}, _polynom(3 * (_keys.size() - 1))
+    {}
+
+    // Methods //
+public:
+    void generate()
+    {
+        size_t n = _keys.size();
+        XMVECTOR d_prev = XMVectorZero(), w_prev = XMVectorZero(), w_prev2 = XMVectorZero();
+
+        for (size_t i = 1; i < n; ++i)
+        {
+            float h = _times[i] - _times[i - 1];
+            XMVECTOR d = XMVectorScale(XMVectorSubtract(_keys[i], _keys[i - 1]), 2.f / h);
+            XMVECTOR w = XMVectorAdd(XMVectorSubtract(d, d_prev), w_prev2);
+
+            _polynom[3 * (i - 1) + 0] = XMVectorScale(XMVectorSubtract(w, w_prev), .5f / h);
+            _polynom[3 * (i - 1) + 1] = w_prev;
+            _polynom[3 * (i - 1) + 2] = _keys[i - 1];
+
+            d_prev = d;
+            w_prev2 = w_prev;
+            w_prev = w;
+        }
+        _dirty = false;
+    }
+
+    void update()
+    {
+        if (_dirty) generate();
+    }
+
+    /**
+     * @brief   The position at time, requires an up to date track (see update()).
+     */
+    XMVECTOR evaluate(float time) const
+    {
+        size_t i = track_segment(_times, time);
+        XMVECTOR t = XMVectorReplicate(time - _times[i]);
+        const XMVECTOR * p = _polynom.data() + 3 * i;
+        return XMVectorMultiplyAdd(XMVectorMultiplyAdd(p[0], t, p[1]), t, p[2]);
+    }
+};
+
+/**
+ * @brief   Rotation track interpolating quaternion keys with squad (spherical cubic), which is
+ *          C1 across the keys unlike piecewise slerp.
+ *
+ * Neighbouring keys are flipped into the same hemisphere and the squad control points
+ * (XMQuaternionSquadSetup) are precomputed per segment, so evaluation is a single
+ * XMQuaternionSquad.
+ *
+ * @ingroup Eye
+ * @author  Ronja Schnur (rschnur@students.uni-mainz.de)
+ */
+class RotationTrack
+{
+    // Data //
+private:
+    std::vector<float> _times;
+    std::vector<XMVECTOR> _keys;
+    std::vector<XMVECTOR> _control; // a_0, b_0, c_0, a_1, ...
+    bool _dirty{true};
+
+    // Properties //
+public:
+    size_t size() const { return _keys.size(); }
+
+    float time(size_t i) const { return _times[i]; }
+
+    XMVECTOR key(size_t i) const { return _keys[i]; }
+
+    void key(size_t i, const XMVECTOR & rotation_q)
+    {
+        _keys[i] = XMQuaternionNormalize(rotation_q);
+        _dirty = true;
+    }
+
+    // Constructors //
+public:
+    /**
+     * @param   times   Strictly increasing key times (at least two).
+     * @param   keys    The rotations (quaternions) at the key times.
+     */
+    RotationTrack(std::vector<float> times, std::vector<XMVECTOR> keys)
+        : _times{std::move(times)}, _keys{std::move(keys)}, _control(3 * (_keys.size() - 1))
+    {
+        for (auto & q : _keys) q = XMQuaternionNormalize(q);
+    }
+
+    // Methods //
+public:
+    void generate()
+    {
+        size_t n = _keys.size();
+        for (size_t i = 1; i < n; ++i) // shortest arcs
+            if (XMVectorGetX(XMQuaternionDot(_keys[i - 1], _keys[i])) < 0.f)
+                _keys[i] = XMVectorNegate(_keys[i]);
+
+        for (size_t i = 0; i + 1 < n; ++i)
+        {
+            XMVECTOR q_0 = _keys[i ? i - 1 : 0], q_3 = _keys[(std::min)(i + 2, n - 1)];
+            XMQuaternionSquadSetup(&_control[3 * i], &_control[3 * i + 1], &_control[3 * i + 2],
+                                   q_0, _keys[i], _keys[i + 1], q_3);
+        }
+        _dirty = false;
+    }
+
+    void update()
+    {
+        if (_dirty) generate();
+    }
+
+    /**
+     * @brief   The rotation at time, requires an up to date track (see update()).
+     */
+    XMVECTOR evaluate(float time) const
+    {
+        size_t i = track_segment(_times, time);
+        float t = (time - _times[i]) / (_times[i + 1] - _times[i]);
+        const XMVECTOR * c = _control.data() + 3 * i;
+        return XMQuaternionSquad(_keys[i], c[0], c[1], c[2], t);
+    }
+};
+
+/**
+ * @brief   Animates position and rotation of an Object. Either track may be empty.
+ *
+ * @ingroup Eye
+ * @author  Ronja Schnur (rschnur@students.uni-mainz.de)
+ */
+class TransformTrack
+{
+    // Data //
+private:
+    std::shared_ptr<PositionTrack> _position;
+    std::shared_ptr<RotationTrack> _rotation;
+
+    // Properties //
+public:
+    std::shared_ptr<PositionTrack> position() { return _position; }
+
+    std::shared_ptr<RotationTrack> rotation() { return _rotation; }
+
+    // Constructors //
+public:
+    TransformTrack(std::shared_ptr<PositionTrack> position, std::shared_ptr<RotationTrack> rotation)
+        : _position{std::move(position)}, _rotation{std::move(rotation)}
+    {}
+
+    // Methods //
+public:
+    void update()
+    {
+        if (_position) _position->update();
+        if (_rotation) _rotation->update();
+    }
+
+    XMVECTOR position(float time) const
+    {
+        return _position ? _position->evaluate(time) : XMVectorZero();
+    }
+
+    XMVECTOR rotation(float time) const
+    {
+        return _rotation ? _rotation->evaluate(time) : XMQuaternionIdentity();
+    }
+
+    /**
+     * @brief   Writes position and rotation at time to object.
+     */
+    void apply(Object & object, float time) const
+    {
+        if (_position) object.position(_position->evaluate(time));
+        if (_rotation) object.rotation(_rotation->evaluate(time));
+    }
+
+    /**
+     * @brief   Evaluates count tracks at time and writes their model matrices (with scale_v)
+     *          straight into out, e.g. an instance or constant buffer array. The tracks have to
+     *          be up to date (see update()).
+     */
+    static void evaluate(const TransformTrack * tracks, size_t count, float time,
+                         const XMVECTOR & scale_v, XMFLOAT4X4 * out)
+    {
+        const XMVECTOR origin = XMVectorZero();
+        for (size_t i = 0; i < count; ++i)
+        {
+            XMMATRIX m = XMMatrixAffineTransformation(scale_v, origin, tracks[i].rotation(time),
+                                                      tracks[i].position(time));
+            XMStoreFloat4x4(out + i, m);
+        }
+    }
+
+    /**
+     * @brief   Evaluates count tracks at time into separate position and rotation arrays.
+     */
+    static void evaluate(const TransformTrack * tracks, size_t count, float time,
+                         XMVECTOR * positions_v, XMVECTOR * rotations_q)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            positions_v[i] = tracks[i].position(time);
+            rotations_q[i] = tracks[i].rotation(time);
+        }
+    }
+};
+
+} // namespace _implementation
+
+using _implementation::PositionTrack;
+using _implementation::RotationTrack;
+using _implementation::TransformTrack;
+
+} // namespace My::Eye
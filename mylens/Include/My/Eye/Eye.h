@@ -7,6 +7,7 @@
 #include "Eye/Scene.h"
 
 #include "Eye/Camera.h"
+#include "Eye/CurveTrack.h"
 
 #include "Utility/winrtUtility.h"
 
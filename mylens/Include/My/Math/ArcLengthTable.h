@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace My::Math
+{
+
+/**
+ * @brief   Cumulative arc length of the graph of a quadratic spline, with inverse lookup for
+ *          constant speed traversal.
+ *
+ * The arc length of a polynom a x^2 + b x + c between x_0 and x_1 has the closed form
+ *
+ *      (G(u_1) - G(u_0)) / 4a,   G(u) = u sqrt(1 + u^2) + asinh(u),   u = 2a x + b
+ *
+ * which is used per segment; for almost linear segments (u_1 - u_0 small) it cancels, there
+ * Simpson's rule is exact up to rounding. The table stores the length up to each knot, so
+ * arcLength() and parameter() are one binary search plus one segment (parameter() solves the
+ * segment with a few safeguarded Newton steps). Behind the intervall the spline is constant and
+ * the lookups are clamped to it.
+ *
+ *      ArcLengthTable<float> table{spline.arcLengthTable()};
+ *      for (size_t k = 0; k < frames; ++k) x = table.parameter(speed * k); // constant speed
+ *
+ * @tparam  value_t     The floating point type to operate on.
+ *
+ * @ingroup Math
+ * @author  Ronja Schnur (rschnur@students.uni-mainz.de)
+ */
+template <typename value_t> class ArcLengthTable
+{
+    // Data
+private:
+    std::vector<value_t> _knot_x, _polynom;
+    std::vector<value_t> _length; // arc length from the first knot to each knot
+
+    // Properties
+public:
+    bool empty() const noexcept { return _length.empty(); }
+
+    /**
+     * @brief   Arc length of the whole intervall.
+     */
+    value_t length() const noexcept { return _length.empty() ? value_t(0) : _length.back(); }
+
+    // Methods
+private:
+    value_t slope(size_t i, value_t x) const
+    {
+        return 2 * _polynom[3 * i] * x + _polynom[3 * i + 1];
+    }
+
+    static value_t speed(value_t u) { return std::sqrt(1 + u * u); }
+
+    /**
+     * @brief   Arc length of polynom i between x_0 and x_1.
+     */
+    value_t segmentLength(size_t i, value_t x_0, value_t x_1) const
+    {
+        static const value_t linear{
+            std::pow(1000 * std::numeric_limits<value_t>::epsilon(), value_t(0.2))};
+
+        value_t u_0{slope(i, x_0)}, u_1{slope(i, x_1)};
+        if (std::abs(u_1 - u_0) < linear)
+            return (x_1 - x_0) / 6 * (speed(u_0) + 4 * speed((u_0 + u_1) / 2) + speed(u_1));
+
+        auto G = [](value_t u) { return u * speed(u) + std::asinh(u); };
+        return (G(u_1) - G(u_0)) / (4 * _polynom[3 * i]);
+    }
+
+    size_t segment(value_t x) const
+    {
+        size_t i(std::upper_bound(_knot_x.begin(), _knot_x.end(), x) - _knot_x.begin());
+        return std::min(std::max(i, size_t(1)), _knot_x.size() - 1) - 1;
+    }
+
+public:
+    /**
+     * @brief   Computes the table for the spline given by its knots and polynom coefficients.
+     *
+     * @param   knot_x      The x-knots (num_knots values).
+     * @param   polynom     The polynom coefficients (3 * (num_knots - 1) values).
+     * @param   num_knots   The number of knots.
+     */
+    void build(const value_t * knot_x, const value_t * polynom, size_t num_knots)
+    {
+        _knot_x.assign(knot_x, knot_x + num_knots);
+        _polynom.assign(polynom, polynom + 3 * (num_knots - 1));
+        _length.resize(num_knots);
+
+        _length[0] = 0;
+        for (size_t i = 1; i < num_knots; ++i)
+            _length[i] = _length[i - 1] + segmentLength(i - 1, _knot_x[i - 1], _knot_x[i]);
+    }
+
+    /**
+     * @brief   Arc length from the first knot to x (clamped to the intervall).
+     */
+    value_t arcLength(value_t x) const
+    {
+        x = std::min(std::max(x, _knot_x.front()), _knot_x.back());
+        size_t i{segment(x)};
+        return _length[i] + segmentLength(i, _knot_x[i], x);
+    }
+
+    /**
+     * @brief   Inverse of arcLength(): the x at which the arc length reaches s (clamped to
+     *          [0, length()]).
+     */
+    value_t parameter(value_t s) const
+    {
+        if (!(s > 0)) return _knot_x.front();
+        if (!(s < length())) return _knot_x.back();
+
+        size_t i(std::upper_bound(_length.begin(), _length.end(), s) - _length.begin() - 1);
+        i = std::min(i, _knot_x.size() - 2);
+
+        value_t lo{_knot_x[i]}, hi{_knot_x[i + 1]}, r{s - _length[i]};
+        value_t x{lo + (hi - lo) * r / (_length[i + 1] - _length[i])};
+        const value_t tolerance{4 * std::numeric_limits<value_t>::epsilon() * length()};
+
+        for (size_t k = 0; k < 32; ++k)
+        {
+            value_t g{segmentLength(i, _knot_x[i], x) - r};
+            if (std::abs(g) <= tolerance) break;
+            (g < 0 ? lo : hi) = x;
+
+            value_t next{x - g / speed(slope(i, x))};
+            x = (next > lo && next < hi) ? next : (lo + hi) / 2; // bisect if newton leaves
+        }
+        return x;
+    }
+
+    /**
+     * @brief   Writes count x-values with equal arc length distance, from the first to the last
+     *          knot, to xs.
+     */
+    void sample(size_t count, value_t * xs) const
+    {
+        for (size_t k = 0; k < count; ++k)
+            xs[k] = parameter(count > 1 ? length() * value_t(k) / value_t(count - 1) : value_t(0));
+    }
+};
+
+} // namespace My::Math
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+
+#include "Math/Intervall.h"
+
+namespace My::Math
+{
+
+/**
+ * @brief   Immutable snapshot of a generated QuadraticSpline (or subclass), see
+ *          QuadraticSpline::compile(). All of its functions are const and it never changes after
+ *          construction, so any number of threads may evaluate it while the spline it was
+ *          compiled from is edited.
+ *
+ * The knots and polynoms live in one block aligned to a cache line, the polynoms start on a
+ * cache line of their own. Evaluation matches evaluate() of the spline at compile time.
+ *
+ * @tparam  value_t     The floating point type to operate on.
+ *
+ * @ingroup Math
+ * @author  Ronja Schnur (rschnur@students.uni-mainz.de)
+ */
+template <typename value_t> class alignas(64) CompiledSpline
+{
+    // Data
+public:
+    static constexpr size_t alignment = 64;
+
+private:
+    struct Deleter
+    {
+        void operator()(value_t * p) const { ::operator delete(p, std::align_val_t{alignment}); }
+    };
+
+    std::unique_ptr<value_t[], Deleter> _data;
+    const value_t *_knot_x, *_polynom;
+    size_t _n;
+    value_t _start, _delta, _tail;
+    bool _uniform;
+
+    // Constructors
+public:
+    /**
+     * @brief   Copies the generated spline.
+     *
+     * @param   knot_x      n x-knots.
+     * @param   polynom     (n - 1) * 3 coefficients: a_0, b_0, c_0, a_1, ...
+     * @param   n           Number of knots (at least 2).
+     * @param   uniform     Whether the knots are equally distributed with distance delta.
+     * @param   delta       The knot distance of uniform knots.
+     */
+    CompiledSpline(const value_t * knot_x, const value_t * polynom, size_t n, bool uniform,
+                   value_t delta)
+        : _n{n}, _start{knot_x[0]}, _delta{delta}, _uniform{uniform}
+    {
+        constexpr size_t line{alignment / sizeof(value_t)};
+        size_t knots{(n + line - 1) / line * line};
+
+        auto * data{static_cast<value_t *>(::operator new(
+            (knots + 3 * (n - 1)) * sizeof(value_t), std::align_val_t{alignment}))};
+        _data.reset(data);
+
+        std::copy(knot_x, knot_x + n, data);
+        std::copy(polynom, polynom + 3 * (n - 1), data + knots);
+        _knot_x = data;
+        _polynom = data + knots;
+        _tail = polynomial(n - 2, _knot_x[n - 1]);
+    }
+
+    CompiledSpline(const CompiledSpline &) = delete;
+    CompiledSpline & operator=(const CompiledSpline &) = delete;
+
+    // Properties
+public:
+    size_t numKnots() const noexcept { return _n; }
+
+    bool uniform() const noexcept { return _uniform; }
+
+    Intervall<value_t> intervall() const noexcept { return {_knot_x[0], _knot_x[_n - 1]}; }
+
+    const value_t * knotXData() const noexcept { return _knot_x; }
+
+    const value_t * polynomData() const noexcept { return _polynom; }
+
+    // Methods
+private:
+    size_t segment(value_t value) const
+    {
+        if (!(value > _start)) return 0;
+        if (_uniform) return std::min(size_t((value - _start) / _delta), _n - 1);
+        return size_t(std::upper_bound(_knot_x, _knot_x + _n, value) - _knot_x) - 1;
+    }
+
+    value_t polynomial(size_t i, value_t x) const
+    {
+        const value_t * p{_polynom + 3 * i};
+        return p[0] * x * x + p[1] * x + p[2];
+    }
+
+public:
+    value_t evaluate(value_t value) const
+    {
+        size_t i{segment(value)};
+        return i < _n - 1 ? polynomial(i, value) : _tail;
+    }
+
+    value_t operator()(value_t value) const { return evaluate(value); }
+
+    value_t derivative(value_t value) const
+    {
+        const value_t * p{_polynom + 3 * std::min(segment(value), _n - 2)};
+        return 2 * p[0] * value + p[1];
+    }
+
+    /**
+     * @brief   Evaluates the spline at n positions.
+     */
+    void evaluate(const value_t * xs, value_t * out, size_t n) const
+    {
+        for (size_t i = 0; i < n; ++i) out[i] = evaluate(xs[i]);
+    }
+};
+
+/**
+ * @brief   Hands the latest CompiledSpline from one writer (e.g. an editor) to any number of
+ *          readers (e.g. render and worker threads) without locks on their side.
+ *
+ *      // writer                                // reader
+ *      spline.specify(3, 0.5f);                 auto snapshot = publisher.load();
+ *      publisher.publish(spline.compile());     float y = snapshot->evaluate(x);
+ *
+ * Publishing swaps a shared_ptr atomically. A reader keeps the snapshot it loaded, which stays
+ * consistent and alive until its last reader releases it, however often newer ones are
+ * published meanwhile (read-copy-update).
+ *
+ * @tparam  value_t     The floating point type to operate on.
+ *
+ * @ingroup Math
+ * @author  Ronja Schnur (rschnur@students.uni-mainz.de)
+ */
+template <typename value_t> class SplinePublisher
+{
+    // Data
+private:
+    std::shared_ptr<const CompiledSpline<value_t>> _current;
+
+    // Constructors
+public:
+    SplinePublisher() = default;
+
+    explicit SplinePublisher(std::shared_ptr<const CompiledSpline<value_t>> spline)
+        : _current{std::move(spline)}
+    {}
+
+    SplinePublisher(const SplinePublisher &) = delete;
+    SplinePublisher & operator=(const SplinePublisher &) = delete;
+
+    // Methods
+public:
+    /**
+     * @brief   Replaces the current snapshot, readers pick it up on their next load().
+     */
+    void publish(std::shared_ptr<const CompiledSpline<value_t>> spline)
+    {
+        std::atomic_store_explicit(&_current, std::move(spline), std::memory_order_release);
+    }
+
+    /**
+     * @brief   The current snapshot (nullptr if nothing was published yet).
+     */
+    std::shared_ptr<const CompiledSpline<value_t>> load() const
+    {
+        return std::atomic_load_explicit(&_current, std::memory_order_acquire);
+    }
+};
+
+} // namespace My::Math
@@ -0,0 +1,246 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "Math/Intervall.h"
+#include "Math/Spline.h"
+#include "Math/Tridiagonal.h"
+
+namespace My::Math
+{
+
+/**
+ * @brief   Natural cubic spline (C2, second derivative 0 at both ends).
+ *
+ * Every polynom is stored relative to its left knot, p_i(x) = a t^3 + b t^2 + c t + d with
+ * t = x - x_i, as 4 coefficients per polynom in _polynom (a_0, b_0, c_0, d_0, a_1, ...). The
+ * local form keeps cubic terms from cancelling far away from the origin. Like
+ * @ref QuadraticSpline the first polynom continues in front of the intervall and the spline is
+ * constant behind it.
+ *
+ * The second derivatives at the knots solve a tridiagonal system (see @ref solveTridiagonal).
+ * generate(splines, count) builds many splines with the same number of knots at once, with
+ * their systems interleaved across SIMD lanes.
+ *
+ * @tparam  value_t     The floating point type to operate on.
+ *
+ * @ingroup Math
+ * @author  Ronja Schnur (rschnur@students.uni-mainz.de)
+ */
+template <typename value_t> class CubicSpline : public Spline<value_t>
+{
+    // Data
+protected:
+    bool _uniform{true};
+    bool _dirty{true};
+
+    // Constructors
+public:
+    /**
+     * @brief   Create new instance with equally distributed knots.
+     *
+     * @param   num_knots   Number of knots.
+     * @param   intervall   Intervall in which the spline curve lives.
+     */
+    CubicSpline(size_t num_knots, Intervall<value_t> intervall)
+        : Spline<value_t>(num_knots, std::move(intervall))
+    {
+        this->_polynom = std::vector<value_t>((num_knots - 1) * 4);
+    }
+
+    /**
+     * @brief   Create new instance.
+     *
+     * @param   knot_x   x-Knot Values
+     * @param   knot_y   y-Knot Values
+     */
+    CubicSpline(std::vector<value_t> knot_x, std::vector<value_t> knot_y)
+        : Spline<value_t>(knot_x.size(), Intervall<value_t>{knot_x.front(), knot_x.back()}),
+          _uniform{false}
+    {
+        this->_polynom = std::vector<value_t>((this->numKnots() - 1) * 4);
+        std::copy(knot_x.begin(), knot_x.end(), this->_knot_x.begin());
+        std::copy(knot_y.begin(), knot_y.end(), this->_knot_y.begin());
+    }
+
+    CubicSpline(const CubicSpline<value_t> & o)
+        : Spline<value_t>(o), _uniform{o._uniform}, _dirty{o._dirty}
+    {}
+
+    // Properties
+public:
+    void specify(size_t knot, value_t value) override
+    {
+        this->_knot_y[knot] = value;
+        _dirty = true;
+    }
+
+    void specifyX(size_t knot, value_t value) override
+    {
+        _uniform = false;
+        _dirty = true;
+        this->_knot_x[knot] = value;
+        if (knot == 0) this->_intervall._start = value;
+        if (knot == this->_knot_x.size() - 1) this->_intervall._end = value;
+    }
+
+    bool dirty() const noexcept { return _dirty; }
+
+    /**
+     * @brief   Whether the knots are equally distributed.
+     */
+    bool uniform() const noexcept { return _uniform; }
+
+    // Methods
+protected:
+    void invalidate(size_t) override { _dirty = true; }
+
+    size_t segment(value_t value) const
+    {
+        const auto & x{this->_knot_x};
+        if (!(value > x[0])) return 0;
+        if (_uniform) return std::min(size_t((value - x[0]) / this->_delta), x.size() - 1);
+        return size_t(std::upper_bound(x.begin(), x.end(), value) - x.begin()) - 1;
+    }
+
+    /**
+     * @brief   Writes row k of the system for the second derivatives at the inner knots to
+     *          lower, diag, upper and rhs (at index at).
+     */
+    void system(size_t k, size_t at, value_t * lower, value_t * diag, value_t * upper,
+                value_t * rhs) const
+    {
+        const auto &x{this->_knot_x}, &y{this->_knot_y};
+        size_t i{k + 1};
+        value_t h_0{x[i] - x[i - 1]}, h_1{x[i + 1] - x[i]};
+
+        lower[at] = h_0;
+        diag[at] = 2 * (h_0 + h_1);
+        upper[at] = h_1;
+        rhs[at] = 6 * ((y[i + 1] - y[i]) / h_1 - (y[i] - y[i - 1]) / h_0);
+    }
+
+    /**
+     * @brief   Computes the polynoms from the second derivatives m at the inner knots, m[k] is
+     *          read from m[k * stride].
+     */
+    void coefficients(const value_t * m, size_t stride)
+    {
+        const auto &x{this->_knot_x}, &y{this->_knot_y};
+        auto & p{this->_polynom};
+        size_t n{x.size()};
+        auto M = [&](size_t i) { return (i == 0 || i == n - 1) ? 0 : m[(i - 1) * stride]; };
+
+        for (size_t i = 0; i < n - 1; ++i)
+        {
+            value_t h{x[i + 1] - x[i]}, m_0{M(i)}, m_1{M(i + 1)};
+            p[4 * i + 0] = (m_1 - m_0) / (6 * h);
+            p[4 * i + 1] = m_0 / 2;
+            p[4 * i + 2] = (y[i + 1] - y[i]) / h - h * (2 * m_0 + m_1) / 6;
+            p[4 * i + 3] = y[i];
+        }
+        _dirty = false;
+    }
+
+    value_t polynomial(size_t i, value_t x) const
+    {
+        const auto & k{this->_knot_x};
+        if (i >= k.size() - 1) // constant behind the intervall
+        {
+            i = k.size() - 2;
+            x = k.back();
+        }
+        const value_t * p{this->_polynom.data() + 4 * i};
+        value_t t{x - k[i]};
+        return ((p[0] * t + p[1]) * t + p[2]) * t + p[3];
+    }
+
+    value_t polynomial_derivative(size_t i, value_t x) const
+    {
+        i = std::min(i, this->_knot_x.size() - 2); // last polynom continues behind the intervall
+        const value_t * p{this->_polynom.data() + 4 * i};
+        value_t t{x - this->_knot_x[i]};
+        return (3 * p[0] * t + 2 * p[1]) * t + p[2];
+    }
+
+public:
+    /**
+     * @brief   Computes the polynom coefficients.
+     */
+    void generate() override
+    {
+        CubicSpline<value_t> * self{this};
+        generate(&self, 1);
+    }
+
+    /**
+     * @brief   Computes the polynom coefficients of count splines with the same number of knots
+     *          at once (their x-knots may differ).
+     *
+     * @param   splines     Pointer to count splines.
+     * @param   count       The number of splines.
+     */
+    static void generate(CubicSpline<value_t> * const * splines, size_t count)
+    {
+        if (count == 0) return;
+        size_t n{splines[0]->numKnots()}, m{n - 2};
+        for (size_t s = 0; s < count; ++s)
+            if (splines[s]->numKnots() != n)
+                throw std::runtime_error("CubicSpline: batch needs equal numbers of knots.");
+
+        std::vector<value_t> buffer(5 * m * count);
+        value_t *lower{buffer.data()}, *diag{lower + m * count}, *upper{diag + m * count};
+        value_t *rhs{upper + m * count}, *scratch{rhs + m * count};
+
+        for (size_t s = 0; s < count; ++s)
+            for (size_t k = 0; k < m; ++k)
+                splines[s]->system(k, k * count + s, lower, diag, upper, rhs);
+
+        solveTridiagonal(lower, diag, upper, rhs, m, count, scratch);
+
+        for (size_t s = 0; s < count; ++s) splines[s]->coefficients(rhs + s, count);
+    }
+
+    /**
+     * @brief   Regenerates the polynoms if knots changed since the last generation.
+     */
+    void update()
+    {
+        if (_dirty) generate();
+    }
+
+    /**
+     * @brief   Non-virtual evaluation of the spline, requires a generated spline.
+     */
+    value_t evaluate(value_t value) const { return polynomial(segment(value), value); }
+
+    /**
+     * @brief   Non-virtual evaluation of the derivative, requires a generated spline.
+     */
+    value_t evaluateDerivative(value_t value) const
+    {
+        return polynomial_derivative(segment(value), value);
+    }
+
+    value_t compute(value_t value) override
+    {
+        update();
+        return evaluate(value);
+    }
+
+    value_t derivative(value_t value)
+    {
+        update();
+        return evaluateDerivative(value);
+    }
+
+    std::shared_ptr<Spline<value_t>> copy() override
+    {
+        return std::make_shared<CubicSpline<value_t>>(*this);
+    }
+};
+
+} // namespace My::Math
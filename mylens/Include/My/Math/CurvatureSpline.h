@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <numeric>
+#include <stdexcept>
 #include <vector>
 
 #include "Math/Intervall.h"
@@ -48,10 +49,18 @@ public:
 public:
     size_t numCurvatures() { return _a.size(); }
 
-    void curvature(size_t a, value_t v) { _a[a] = v; }
+    void curvature(size_t a, value_t v)
+    {
+        _a[a] = v;
+        this->invalidate(0); // alpha depends on every curvature
+    }
 
     value_t curvature(size_t a) const { return _a[a]; }
 
+    value_t y0() const noexcept { return _y_0; }
+
+    value_t yN() const noexcept { return _y_n; }
+
     // Methods
 private:
     value_t calpha()
@@ -66,25 +75,8 @@ private:
                ((this->_delta * this->_delta) * (_a[_a.size() - 1] + 3 * A + 2 * B));
     }
 
-private:
-    value_t polynomial(size_t i, value_t x)
-    {
-        if ((i * 3) < this->_polynom.size())
-        {
-            return this->_polynom[i * 3] * x * x + //
-                   this->_polynom[i * 3 + 1] * x + //
-                   this->_polynom[i * 3 + 2];      //
-        }
-        else
-            return _y_n;
-    }
-
-public:
-    void specify(size_t, value_t) override {}
-
-    void specifyX(size_t, value_t) override {} // Don't allow un-uniform
-
-    void generate() override
+protected:
+    void generateFrom(size_t) override
     {
         value_t alpha{calpha()}, delta{this->_delta};
         auto & polynom = this->_polynom;
@@ -106,10 +98,10 @@ public:
                                  polynom[3 * (i - 1) + 1] * delta + polynom[3 * (i - 1) + 2];
         }
 
-        // Move into their corresponding area
-        for (size_t i = 1; i < _a.size(); ++i)
+        // Move into their corresponding area (the recursion is relative to each knot)
+        for (size_t i = 0; i < _a.size(); ++i)
         {
-            value_t p = (delta * i) - this->intervall()._start;
+            value_t p = this->_knot_x[i];
             // a is correct
             // c
             polynom[3 * i + 2] += polynom[3 * i] * p * p - polynom[3 * i + 1] * p;
@@ -118,12 +110,18 @@ public:
         }
     }
 
+public:
+    void specify(size_t, value_t) override {}
+
+    void specifyX(size_t, value_t) override {} // Don't allow un-uniform
+
+    using QuadraticSpline<value_t>::compute;
+
     value_t compute(value_t value) override
     {
         if (this->_uniform)
         {
-            size_t i{size_t((value - this->_intervall._start) / this->_delta)};
-            return polynomial(i, value);
+            return QuadraticSpline<value_t>::compute(value);
         }
         else
         {
@@ -135,6 +133,26 @@ public:
     {
         return std::make_shared<CurvatureSpline<value_t>>(*this);
     }
+
+    /**
+     * @brief   Not supported, the knots of a CurvatureSpline are no values of the curve.
+     *
+     * @throws  std::logic_error always.
+     */
+    size_t insertKnot(value_t) override
+    {
+        throw std::logic_error("CurvatureSpline: knots can not be inserted.");
+    }
+
+    /**
+     * @brief   Not supported, see insertKnot().
+     *
+     * @throws  std::logic_error always.
+     */
+    void removeKnot(size_t) override
+    {
+        throw std::logic_error("CurvatureSpline: knots can not be removed.");
+    }
 };
 
 } // namespace My
@@ -0,0 +1,267 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace My::Math
+{
+
+/**
+ * @brief   Vector dual number for forward mode automatic differentiation: a value and its
+ *          partial derivatives with respect to N variables, propagated by every operation.
+ *
+ * The spline templates accept it as value_t, so a spline over Dual carries the derivatives of
+ * all coefficients with respect to its (seeded) knots through generate() and evaluation, see
+ * valuesAndJacobian(). Comparisons and conversions use the value only. Beside the arithmetic
+ * operators sqrt, abs, trunc, floor, exp, log, sin, cos and pow are overloaded (found by
+ * argument dependent lookup, not through std::).
+ *
+ * @tparam  value_t     The floating point type to operate on.
+ * @tparam  N           The number of variables.
+ *
+ * @ingroup Math
+ * @author  Ronja Schnur (rschnur@students.uni-mainz.de)
+ */
+template <typename value_t, size_t N> class Dual
+{
+    // Data
+public:
+    value_t _v{0};
+    std::array<value_t, N> _d{}; // partial derivatives
+
+    // Constructors
+public:
+    Dual() = default;
+
+    /**
+     * @brief   Create a constant.
+     */
+    Dual(value_t v) : _v{v} {}
+
+    /**
+     * @brief   Create the i-th variable (its derivative with respect to itself is 1).
+     */
+    static Dual variable(value_t v, size_t i)
+    {
+        Dual r{v};
+        r._d[i] = 1;
+        return r;
+    }
+
+    // Properties
+public:
+    value_t value() const noexcept { return _v; }
+
+    value_t derivative(size_t i) const noexcept { return _d[i]; }
+
+    template <typename other_t, typename = std::enable_if_t<std::is_arithmetic_v<other_t>>>
+    explicit operator other_t() const
+    {
+        return other_t(_v);
+    }
+
+    // Operators
+public:
+    Dual operator-() const
+    {
+        Dual r{-_v};
+        for (size_t i = 0; i < N; ++i) r._d[i] = -_d[i];
+        return r;
+    }
+
+    Dual & operator+=(const Dual & o)
+    {
+        _v += o._v;
+        for (size_t i = 0; i < N; ++i) _d[i] += o._d[i];
+        return *this;
+    }
+
+    Dual & operator-=(const Dual & o)
+    {
+        _v -= o._v;
+        for (size_t i = 0; i < N; ++i) _d[i] -= o._d[i];
+        return *this;
+    }
+
+    Dual & operator*=(const Dual & o)
+    {
+        for (size_t i = 0; i < N; ++i) _d[i] = _d[i] * o._v + _v * o._d[i];
+        _v *= o._v;
+        return *this;
+    }
+
+    Dual & operator/=(const Dual & o)
+    {
+        value_t inv{value_t(1) / o._v};
+        _v *= inv;
+        for (size_t i = 0; i < N; ++i) _d[i] = (_d[i] - _v * o._d[i]) * inv;
+        return *this;
+    }
+
+    Dual & operator+=(value_t o)
+    {
+        _v += o;
+        return *this;
+    }
+
+    Dual & operator-=(value_t o)
+    {
+        _v -= o;
+        return *this;
+    }
+
+    Dual & operator*=(value_t o)
+    {
+        _v *= o;
+        for (size_t i = 0; i < N; ++i) _d[i] *= o;
+        return *this;
+    }
+
+    Dual & operator/=(value_t o) { return *this *= value_t(1) / o; }
+
+    friend Dual operator+(Dual a, const Dual & b) { return a += b; }
+    friend Dual operator-(Dual a, const Dual & b) { return a -= b; }
+    friend Dual operator*(Dual a, const Dual & b) { return a *= b; }
+    friend Dual operator/(Dual a, const Dual & b) { return a /= b; }
+
+    friend Dual operator+(Dual a, value_t b) { return a += b; }
+    friend Dual operator-(Dual a, value_t b) { return a -= b; }
+    friend Dual operator*(Dual a, value_t b) { return a *= b; }
+    friend Dual operator/(Dual a, value_t b) { return a /= b; }
+
+    friend Dual operator+(value_t a, Dual b) { return b += a; }
+    friend Dual operator-(value_t a, const Dual & b) { return -b + a; }
+    friend Dual operator*(value_t a, Dual b) { return b *= a; }
+    friend Dual operator/(value_t a, const Dual & b) { return Dual{a} / b; }
+
+    friend bool operator==(const Dual & a, const Dual & b) { return a._v == b._v; }
+    friend bool operator!=(const Dual & a, const Dual & b) { return a._v != b._v; }
+    friend bool operator<(const Dual & a, const Dual & b) { return a._v < b._v; }
+    friend bool operator>(const Dual & a, const Dual & b) { return a._v > b._v; }
+    friend bool operator<=(const Dual & a, const Dual & b) { return a._v <= b._v; }
+    friend bool operator>=(const Dual & a, const Dual & b) { return a._v >= b._v; }
+
+    // Functions
+private:
+    /**
+     * @brief   f(a) with derivative df = f'(a) (chain rule).
+     */
+    static Dual chain(const Dual & a, value_t f, value_t df)
+    {
+        Dual r{f};
+        for (size_t i = 0; i < N; ++i) r._d[i] = df * a._d[i];
+        return r;
+    }
+
+public:
+    friend Dual sqrt(const Dual & a)
+    {
+        value_t s{std::sqrt(a._v)};
+        return chain(a, s, value_t(0.5) / s);
+    }
+
+    friend Dual abs(const Dual & a) { return a._v < 0 ? -a : a; }
+
+    friend Dual trunc(const Dual & a) { return chain(a, std::trunc(a._v), value_t(0)); }
+
+    friend Dual floor(const Dual & a) { return chain(a, std::floor(a._v), value_t(0)); }
+
+    friend Dual exp(const Dual & a)
+    {
+        value_t e{std::exp(a._v)};
+        return chain(a, e, e);
+    }
+
+    friend Dual log(const Dual & a) { return chain(a, std::log(a._v), value_t(1) / a._v); }
+
+    friend Dual sin(const Dual & a) { return chain(a, std::sin(a._v), std::cos(a._v)); }
+
+    friend Dual cos(const Dual & a) { return chain(a, std::cos(a._v), -std::sin(a._v)); }
+
+    friend Dual pow(const Dual & a, value_t e)
+    {
+        return chain(a, std::pow(a._v, e), e * std::pow(a._v, e - 1));
+    }
+};
+
+/**
+ * @brief   Evaluates a spline at n positions together with the derivatives of the results with
+ *          respect to its parameters (the Jacobian), by forward mode automatic differentiation.
+ *
+ * The parameters are written by set(s, j, v) on a copy of spline, as in
+ * SplineFitter::fitParameters, so any spline type works with its own parameters, e.g. the
+ * gradients of a @ref GradientSpline:
+ *
+ *      GradientSpline<Dual<double, 16>> s(16, {0, 1}, y_0, y_n);
+ *      auto set = [](auto & s, size_t j, auto v) { s.specify(j + 1, v); };
+ *      valuesAndJacobian(s, 16, set, gradients, xs, n, values, jacobian);
+ *
+ * Each pass seeds N parameters, so ceil(num_params / N) generations replace the 2 num_params
+ * generations of central finite differences; with N >= num_params it is a single pass. The
+ * derivatives are exact up to rounding.
+ *
+ * @tparam  spline_t    A spline template over Dual<value_t, N>.
+ *
+ * @param   spline      The spline (its parameters are overwritten in the copy).
+ * @param   num_params  The number of parameters.
+ * @param   set         Callable set(spline_t<Dual<value_t, N>> &, size_t j, Dual<value_t, N>).
+ * @param   params      Pointer to num_params values of the parameters.
+ * @param   xs          Pointer to n x-values.
+ * @param   n           The number of values.
+ * @param   values      Pointer to n results.
+ * @param   jacobian    Pointer to n * num_params results, row i holds the gradient at xs[i].
+ *
+ * @ingroup Math
+ */
+template <template <typename> class spline_t, typename value_t, size_t N, typename set_t>
+void valuesAndJacobian(const spline_t<Dual<value_t, N>> & spline, size_t num_params, set_t set,
+                       const value_t * params, const value_t * xs, size_t n, value_t * values,
+                       value_t * jacobian)
+{
+    using dual_t = Dual<value_t, N>;
+    spline_t<dual_t> s{spline};
+    for (size_t j = 0; j < num_params; ++j) set(s, j, dual_t{params[j]});
+
+    for (size_t first = 0; first < num_params; first += N)
+    {
+        size_t count{std::min(N, num_params - first)};
+        for (size_t k = 0; k < count; ++k)
+            set(s, first + k, dual_t::variable(params[first + k], k));
+        s.generate();
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            dual_t r{s.compute(dual_t{xs[i]})};
+            values[i] = r.value();
+            for (size_t k = 0; k < count; ++k)
+                jacobian[i * num_params + first + k] = r.derivative(k);
+        }
+
+        for (size_t k = 0; k < count; ++k) set(s, first + k, dual_t{params[first + k]});
+    }
+}
+
+/**
+ * @brief   The spline at x and its gradient with respect to its parameters, see
+ *          valuesAndJacobian().
+ *
+ * @param   gradient    Pointer to num_params results.
+ *
+ * @return  The value of the spline at x.
+ *
+ * @ingroup Math
+ */
+template <template <typename> class spline_t, typename value_t, size_t N, typename set_t>
+value_t valueAndGradient(const spline_t<Dual<value_t, N>> & spline, size_t num_params, set_t set,
+                         const value_t * params, value_t x, value_t * gradient)
+{
+    value_t value;
+    valuesAndJacobian(spline, num_params, set, params, &x, 1, &value, gradient);
+    return value;
+}
+
+} // namespace My::Math
@@ -0,0 +1,252 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <memory>
+
+#include "Math/Intervall.h"
+#include "Math/Spline.h"
+#include "Math/StaticSpline.h"
+
+namespace My::Math
+{
+
+/**
+ * @brief   QuadraticSpline with a fixed number of knots which lives entirely in std::arrays.
+ *
+ * The math is the one of @ref QuadraticSpline, but generate() and compute() are constexpr, so
+ * small curves (easing, timing) can be baked at compile time:
+ *
+ *      constexpr auto ease = FixedQuadraticSpline<float, 4>(Intervall<float>{0, 1}, //
+ *                                                           {0.f, .2f, .8f, 1.f})
+ *                                .generated();
+ *
+ * Segment lookup for non-uniform knots counts the knots <= x, which is branchless and cheap for
+ * the intended sizes (up to a few dozen knots). Calls are statically dispatched (see
+ * @ref StaticSpline), use @ref FixedSplineAdapter to pass it where a Spline is expected.
+ *
+ * @tparam  value_t     The floating point type to operate on.
+ * @tparam  N           The number of knots.
+ *
+ * @ingroup Math
+ * @author  Ronja Schnur (rschnur@students.uni-mainz.de)
+ */
+template <typename value_t, size_t N>
+class FixedQuadraticSpline : public StaticSpline<FixedQuadraticSpline<value_t, N>, value_t>
+{
+    static_assert(N >= 2, "A spline requires at least two knots.");
+
+    // Data
+protected:
+    std::array<value_t, N> _knot_x{}, _knot_y{};
+    std::array<value_t, (N - 1) * 3> _polynom{}; // p0[0] p0[1] p0[2], p1[0] ...
+    Intervall<value_t> _intervall{};
+    value_t _delta{};
+    bool _uniform{true};
+
+    // Constructors
+public:
+    /**
+     * @brief   Create new instance with equally distributed knots.
+     *
+     * @param   intervall   Intervall in which the spline curve lives.
+     */
+    constexpr FixedQuadraticSpline(Intervall<value_t> intervall)
+        : _intervall{intervall}, _delta{(intervall._end - intervall._start) / value_t(N - 1)}
+    {
+        for (size_t i = 0; i < N; ++i) _knot_x[i] = _intervall._start + value_t(i) * _delta;
+    }
+
+    /**
+     * @brief   Create new instance with equally distributed knots.
+     *
+     * @param   intervall   Intervall in which the spline curve lives.
+     * @param   knot_y      y-Knot Values
+     */
+    constexpr FixedQuadraticSpline(Intervall<value_t> intervall,
+                                   const std::array<value_t, N> & knot_y)
+        : FixedQuadraticSpline(intervall)
+    {
+        _knot_y = knot_y;
+    }
+
+    /**
+     * @brief   Create new instance.
+     *
+     * @param   knot_x   x-Knot Values
+     * @param   knot_y   y-Knot Values
+     */
+    constexpr FixedQuadraticSpline(const std::array<value_t, N> & knot_x,
+                                   const std::array<value_t, N> & knot_y)
+        : _knot_x{knot_x}, _knot_y{knot_y}, _intervall{knot_x[0], knot_x[N - 1]},
+          _delta{(knot_x[N - 1] - knot_x[0]) / value_t(N - 1)}, _uniform{false}
+    {}
+
+    // Properties
+public:
+    constexpr Intervall<value_t> intervall() const noexcept { return _intervall; }
+
+    constexpr size_t numKnots() const noexcept { return N; }
+
+    constexpr const value_t * knotXData() const noexcept { return _knot_x.data(); }
+
+    constexpr const value_t * knotYData() const noexcept { return _knot_y.data(); }
+
+    constexpr const value_t * polynomData() const noexcept { return _polynom.data(); }
+
+    constexpr bool uniform() const noexcept { return _uniform; }
+
+    /**
+     * @brief   Specify knot y-value
+     *
+     * @param   knot    ID which knot is being changed.
+     * @param   value   The new y-value for the knot.
+     */
+    constexpr void specify(size_t knot, value_t value) { _knot_y[knot] = value; }
+
+    constexpr void specifyX(size_t knot, value_t value)
+    {
+        _uniform = false;
+        _knot_x[knot] = value;
+        if (knot == 0) _intervall._start = value;
+        if (knot == N - 1) _intervall._end = value;
+    }
+
+    // Methods
+private:
+    constexpr size_t segment(value_t value) const
+    {
+        if (!(value > _knot_x[0])) return 0;
+        if (_uniform)
+        {
+            size_t i{size_t((value - _knot_x[0]) / _delta)};
+            return i < N - 1 ? i : N - 1;
+        }
+
+        size_t i{0};
+        for (size_t k = 1; k < N; ++k) i += size_t(!(value < _knot_x[k]));
+        return i;
+    }
+
+public:
+    /**
+     * @brief   Computes the polynom coefficients, see QuadraticSpline::generate.
+     */
+    constexpr void generate()
+    {
+        std::array<value_t, N> d{}, w{};
+
+        for (size_t i = 1; i < N; ++i)
+            d[i] = 2 * (_knot_y[i] - _knot_y[i - 1]) / (_knot_x[i] - _knot_x[i - 1]);
+
+        for (size_t i = 1; i < N; ++i) w[i] = d[i] - d[i - 1] + ((i > 1) ? w[i - 2] : 0);
+
+        for (size_t i = 1; i < N; ++i)
+        {
+            size_t id{(i - 1) * 3};
+            value_t x{_knot_x[i - 1]};
+
+            _polynom[id] = value_t(0.5) * (w[i] - w[i - 1]) / (_knot_x[i] - x);
+            _polynom[id + 1] = w[i - 1] - 2 * _polynom[id] * x;
+            _polynom[id + 2] = _polynom[id] * x * x - w[i - 1] * x + _knot_y[i - 1];
+        }
+    }
+
+    /**
+     * @brief   Returns a generated copy, for use in constant expressions.
+     */
+    constexpr FixedQuadraticSpline generated() const
+    {
+        FixedQuadraticSpline s{*this};
+        s.generate();
+        return s;
+    }
+
+    constexpr value_t evaluate(value_t value) const
+    {
+        size_t i{segment(value)};
+        if (i == N - 1) return _knot_y[N - 1];
+        return (_polynom[i * 3] * value + _polynom[i * 3 + 1]) * value + _polynom[i * 3 + 2];
+    }
+
+    constexpr value_t compute(value_t value) const { return evaluate(value); }
+
+    constexpr value_t evaluateDerivative(value_t value) const
+    {
+        size_t i{segment(value)};
+        i = i < N - 2 ? i : N - 2;
+        return 2 * _polynom[i * 3] * value + _polynom[i * 3 + 1];
+    }
+};
+
+/**
+ * @brief   Exposes a @ref FixedQuadraticSpline through the Spline interface. Knot changes are
+ *          forwarded, generate() mirrors the coefficients into the Spline storage so
+ *          polynomData() and the free spline operators keep working.
+ *
+ * @tparam  value_t     The floating point type to operate on.
+ * @tparam  N           The number of knots.
+ *
+ * @ingroup Math
+ * @author  Ronja Schnur (rschnur@students.uni-mainz.de)
+ */
+template <typename value_t, size_t N> class FixedSplineAdapter : public Spline<value_t>
+{
+    // Data
+private:
+    FixedQuadraticSpline<value_t, N> _spline;
+
+    // Constructors
+public:
+    FixedSplineAdapter(const FixedQuadraticSpline<value_t, N> & spline)
+        : Spline<value_t>(N, spline.intervall()), _spline{spline}
+    {
+        std::copy(spline.knotXData(), spline.knotXData() + N, this->_knot_x.begin());
+        std::copy(spline.knotYData(), spline.knotYData() + N, this->_knot_y.begin());
+        this->_polynom.assign(spline.polynomData(), spline.polynomData() + (N - 1) * 3);
+    }
+
+    // Properties
+public:
+    /**
+     * @brief   Access the wrapped spline.
+     */
+    const FixedQuadraticSpline<value_t, N> & spline() const noexcept { return _spline; }
+
+    void specify(size_t knot, value_t value) override
+    {
+        _spline.specify(knot, value);
+        this->_knot_y[knot] = value;
+    }
+
+    void specifyX(size_t knot, value_t value) override
+    {
+        _spline.specifyX(knot, value);
+        this->_knot_x[knot] = value;
+        this->_intervall = _spline.intervall();
+    }
+
+    // Methods
+protected:
+    void invalidate(size_t knot) override
+    {
+        for (size_t i = knot; i < N; ++i) _spline.specify(i, this->_knot_y[i]);
+    }
+
+public:
+    value_t compute(value_t value) override { return _spline.compute(value); }
+
+    void generate() override
+    {
+        _spline.generate();
+        std::copy(_spline.polynomData(), _spline.polynomData() + (N - 1) * 3,
+                  this->_polynom.begin());
+    }
+
+    std::shared_ptr<Spline<value_t>> copy() override
+    {
+        return std::make_shared<FixedSplineAdapter<value_t, N>>(*this);
+    }
+};
+
+} // namespace My::Math
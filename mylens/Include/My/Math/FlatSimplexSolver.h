@@ -0,0 +1,446 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <vector>
+
+#include "Math/Parallel.h"
+#include "Math/SimplexFunction.h"
+#include "Math/SimplexFunctionArgument.h"
+
+namespace My::Math
+{
+
+/**
+ * @brief   Non owning view of size() contiguous values.
+ *
+ * @ingroup Math
+ */
+template <typename T> class Span
+{
+    // Data
+private:
+    T * _data{nullptr};
+    size_t _size{0};
+
+    // Constructors
+public:
+    Span() = default;
+
+    Span(T * data, size_t size) : _data{data}, _size{size} {}
+
+    /**
+     * @brief   View of a contiguous container (std::vector, std::array, Span of non const T).
+     */
+    template <typename container_t>
+    Span(container_t & c) : _data{c.data()}, _size{c.size()}
+    {}
+
+    // Properties
+public:
+    T * data() const noexcept { return _data; }
+
+    size_t size() const noexcept { return _size; }
+
+    bool empty() const noexcept { return _size == 0; }
+
+    T * begin() const noexcept { return _data; }
+
+    T * end() const noexcept { return _data + _size; }
+
+    T & operator[](size_t i) const noexcept { return _data[i]; }
+};
+
+/**
+ * @brief   Interface to use with the @ref FlatSimplexSolver, the argument is a point of R^N.
+ *
+ * @tparam  value_t     The floating point type to operate on.
+ *
+ * @ingroup Math
+ * @author  Ronja Schnur (rschnur@students.uni-mainz.de)
+ */
+template <typename value_t> class FlatSimplexFunction
+{
+    // Methods
+public:
+    virtual ~FlatSimplexFunction() = default;
+
+    /**
+     * @brief   Computes the function at x. x is only valid during the call.
+     */
+    virtual value_t compute(Span<const value_t> x) = 0;
+
+    value_t operator()(Span<const value_t> x) { return compute(x); }
+
+    /**
+     * @brief   Whether compute() may run concurrently. The solver then evaluates the points of
+     *          initialization and shrink in parallel (see @ref ThreadPool). Override to opt in.
+     */
+    virtual bool threadSafe() const { return false; }
+};
+
+/**
+ * @brief   Runs a @ref SimplexFunction in a @ref FlatSimplexSolver.
+ *
+ * The coordinates of each point are written into a scratch argument (a copy of the prototype,
+ * one per concurrent evaluation, made on first use) with SimplexFunctionArgument::set(), then
+ * preCompute() and compute() run on it. So an evaluation allocates nothing unless the argument
+ * or function does. The arithmetic of the flat solver is the one of R^N, custom
+ * add()/sub()/mul()/div() of the argument are not used.
+ *
+ * @tparam  value_t     The floating point type to operate on.
+ *
+ * @ingroup Math
+ * @author  Ronja Schnur (rschnur@students.uni-mainz.de)
+ */
+template <typename value_t> class SimplexFunctionAdapter : public FlatSimplexFunction<value_t>
+{
+    // Data
+private:
+    using argument_t = std::shared_ptr<SimplexFunctionArgument<value_t>>;
+
+    std::shared_ptr<SimplexFunction<value_t>> _function;
+    argument_t _argument;           // prototype
+    std::vector<argument_t> _free; // scratch arguments not in use
+    std::mutex _mutex;
+
+    // Constructors
+public:
+    SimplexFunctionAdapter(std::shared_ptr<SimplexFunction<value_t>> function,
+                           const argument_t & prototype)
+        : _function{std::move(function)}, _argument{prototype->copy()}, _free{prototype->copy()}
+    {}
+
+    // Methods
+public:
+    bool threadSafe() const override { return _function->threadSafe(); }
+
+    value_t compute(Span<const value_t> x) override
+    {
+        argument_t argument;
+        {
+            std::lock_guard<std::mutex> lock{_mutex};
+            if (_free.empty())
+                argument = _argument->copy();
+            else
+            {
+                argument = std::move(_free.back());
+                _free.pop_back();
+            }
+        }
+
+        for (size_t i = 0; i < x.size(); ++i) argument->set(i, x[i]);
+        _function->preCompute(argument);
+        value_t result{_function->compute(argument)};
+
+        std::lock_guard<std::mutex> lock{_mutex};
+        _free.push_back(std::move(argument));
+        return result;
+    }
+
+    /**
+     * @brief   The coordinates of an argument.
+     */
+    static std::vector<value_t>
+    coordinates(const std::shared_ptr<SimplexFunctionArgument<value_t>> & argument)
+    {
+        std::vector<value_t> x(argument->N());
+        for (size_t i = 0; i < x.size(); ++i) x[i] = argument->get(i);
+        return x;
+    }
+
+    /**
+     * @brief   A new argument (copy of the prototype) at x, precomputed.
+     */
+    std::shared_ptr<SimplexFunctionArgument<value_t>> argument(Span<const value_t> x) const
+    {
+        auto result{_argument->copy()};
+        for (size_t i = 0; i < x.size(); ++i) result->set(i, x[i]);
+        _function->preCompute(result);
+        return result;
+    }
+};
+
+/**
+ * @brief   NelderMeadSimplex algorithm like @ref SimplexSolver (same steps, coefficients and
+ *          stopping criterion) on points of R^N in flat storage.
+ *
+ * The N + 1 vertices are the rows of one contiguous (N + 1) x N matrix, sorted through an index
+ * permutation instead of moving them. The centroid and the trial points live in buffers
+ * allocated by the constructor, so solve() does not allocate (besides what the function does).
+ *
+ * An iteration that replaces the worst vertex costs O(N) besides the evaluations: the sum of all
+ * vertices is updated by the difference (the centroid is the sum without the worst vertex) and
+ * the new vertex is moved to its place in the order by binary search. The sum is recomputed
+ * after every N + 1 replacements to limit rounding drift, a shrink recomputes and sorts all.
+ *
+ * If the function is FlatSimplexFunction::threadSafe(), the N + 1 points of the initialization
+ * and the N points of a shrink are evaluated concurrently on a @ref ThreadPool. Each result goes
+ * to the vertex it belongs to, so the solve is the same as on one thread.
+ *
+ * @tparam  value_t     The floating point type to operate on.
+ *
+ * @ingroup Math
+ * @author  Ronja Schnur (rschnur@students.uni-mainz.de)
+ */
+template <typename value_t> class FlatSimplexSolver
+{
+    // Data
+private:
+    std::shared_ptr<FlatSimplexFunction<value_t>> _function;
+    size_t _n;
+
+    std::vector<value_t> _init_state;
+    std::vector<value_t> _vertices; // (N + 1) x N, row major
+    std::vector<value_t> _values;   // one per row
+    std::vector<size_t> _order;     // rows by ascending value
+    std::vector<value_t> _sum;      // of all vertices
+    std::vector<value_t> _centroid, _reflected, _trial;
+
+    value_t _lambda, _tolerance;
+    size_t _iterations{0}, _evaluations{0};
+    size_t _updates{0}; // replacements since the sum was computed
+    bool _stopped{false};
+    ThreadPool * _pool{&threadPool()};
+    std::function<bool(size_t, value_t)> _monitor;
+
+    // Constructors
+public:
+    /**
+     * @brief   Construct a @ref FlatSimplexSolver.
+     *
+     * @param   function    The function that is to be minimized.
+     * @param   init_state  The start point (N values, copied).
+     * @param   lambda      The constant offset for initializing the simplex.
+     * @param   tolerance   The tolerance value when to stop the optimization.
+     */
+    FlatSimplexSolver(std::shared_ptr<FlatSimplexFunction<value_t>> function,
+                      Span<const value_t> init_state, value_t lambda, value_t tolerance)
+        : _function{std::move(function)}, _n{init_state.size()},
+          _init_state(init_state.begin(), init_state.end()), _vertices((_n + 1) * _n),
+          _values(_n + 1), _order(_n + 1), _sum(_n), _centroid(_n), _reflected(_n), _trial(_n),
+          _lambda{lambda}, _tolerance{tolerance}
+    {}
+
+    // Properties
+public:
+    size_t N() const noexcept { return _n; }
+
+    /**
+     * @brief   The number of iterations of the last solve().
+     */
+    size_t iterations() const noexcept { return _iterations; }
+
+    /**
+     * @brief   The number of function evaluations of the last solve().
+     */
+    size_t evaluations() const noexcept { return _evaluations; }
+
+    /**
+     * @brief   Whether the monitor stopped the last solve() before convergence.
+     */
+    bool stopped() const noexcept { return _stopped; }
+
+    /**
+     * @brief   The i-th best vertex of the simplex (0 is the best).
+     */
+    Span<const value_t> vertex(size_t i) const { return {row(_order[i]), _n}; }
+
+    value_t value(size_t i) const { return _values[_order[i]]; }
+
+    Span<const value_t> best() const { return vertex(0); }
+
+    value_t bestValue() const { return value(0); }
+
+    /**
+     * @brief   Sets the pool evaluating thread safe functions (default: threadPool()).
+     */
+    void pool(ThreadPool & pool) noexcept { _pool = &pool; }
+
+    /**
+     * @brief   Sets a callable monitor(iteration, best value) checked before every iteration,
+     *          solve() stops early when it returns false.
+     */
+    void monitor(std::function<bool(size_t, value_t)> monitor) { _monitor = std::move(monitor); }
+
+    // Methods
+private:
+    value_t * row(size_t r) { return _vertices.data() + r * _n; }
+
+    const value_t * row(size_t r) const { return _vertices.data() + r * _n; }
+
+    value_t evaluate(const value_t * x)
+    {
+        ++_evaluations;
+        return _function->compute({x, _n});
+    }
+
+    /**
+     * @brief   Evaluates the vertices _order[first] .. _order[N].
+     */
+    void evaluateVertices(size_t first)
+    {
+        auto f = [&](size_t i) {
+            size_t r{_order[first + i]};
+            _values[r] = _function->compute({row(r), _n});
+        };
+        if (_function->threadSafe())
+            _pool->run(_n + 1 - first, f);
+        else
+            for (size_t i = 0; i + first <= _n; ++i) f(i);
+        _evaluations += _n + 1 - first;
+    }
+
+    void initializeSimplex()
+    {
+        for (size_t r = 0; r <= _n; ++r)
+        {
+            value_t * x{row(r)};
+            std::copy(_init_state.begin(), _init_state.end(), x);
+            if (r > 0) x[r - 1] += _lambda;
+        }
+        std::iota(_order.begin(), _order.end(), size_t(0));
+        evaluateVertices(0);
+    }
+
+    void sortSimplex()
+    {
+        std::sort(_order.begin(), _order.end(),
+                  [&](size_t a, size_t b) { return _values[a] < _values[b]; });
+    }
+
+    void sumSimplex()
+    {
+        std::fill(_sum.begin(), _sum.end(), value_t(0));
+        for (size_t r = 0; r <= _n; ++r)
+        {
+            const value_t * x{row(r)};
+            for (size_t j = 0; j < _n; ++j) _sum[j] += x[j];
+        }
+        _updates = 0;
+    }
+
+    void massCenter() // of all but the worst vertex
+    {
+        const value_t * x_high{row(_order[_n])};
+        value_t scale{value_t(1) / value_t(_n)};
+        for (size_t j = 0; j < _n; ++j) _centroid[j] = (_sum[j] - x_high[j]) * scale;
+    }
+
+    /**
+     * @brief   out = centroid + s * (centroid - worst)
+     */
+    void affine(value_t s, std::vector<value_t> & out) const
+    {
+        const value_t * x_high{row(_order[_n])};
+        for (size_t j = 0; j < _n; ++j) out[j] = _centroid[j] + s * (_centroid[j] - x_high[j]);
+    }
+
+    /**
+     * @brief   Replaces the worst vertex by x and moves it to its place in the order.
+     */
+    void replaceWorst(const std::vector<value_t> & x, value_t value)
+    {
+        size_t r{_order[_n]};
+        value_t * x_high{row(r)};
+        if (++_updates > _n)
+        {
+            std::copy(x.begin(), x.end(), x_high);
+            sumSimplex();
+        }
+        else
+            for (size_t j = 0; j < _n; ++j)
+            {
+                _sum[j] += x[j] - x_high[j];
+                x_high[j] = x[j];
+            }
+        _values[r] = value;
+
+        auto position{std::upper_bound(_order.begin(), _order.end() - 1, value,
+                                       [&](value_t v, size_t o) { return v < _values[o]; })};
+        std::rotate(position, _order.end() - 1, _order.end());
+    }
+
+public:
+    /**
+     * @brief   Searches for a local optimum, starting from a new simplex around init_state.
+     *
+     * @param   num_iter    Optional pointer receiving the number of iterations.
+     *
+     * @return  The value at the optimum found, see best() for its position.
+     */
+    value_t solve(int * num_iter = nullptr)
+    {
+        _evaluations = 0;
+        _stopped = false;
+        initializeSimplex();
+        if (_n == 0) return _values[0];
+        sortSimplex();
+        sumSimplex();
+
+        using std::abs;
+        size_t k{0};
+        while (abs(value(0) - value(1)) > _tolerance &&
+               !(_monitor && (_stopped = !_monitor(k, value(0))))
+#ifdef _DEBUG
+               && k < 200
+#endif
+        )
+        {
+            k++;
+            value_t low{value(0)}, next_high{value(_n - 1)}, high{value(_n)};
+            massCenter();
+
+            // Reflection
+            affine(value_t(1), _reflected);
+            value_t reflected{evaluate(_reflected.data())};
+            if (low < reflected && reflected < next_high)
+            {
+                replaceWorst(_reflected, reflected);
+                continue;
+            }
+
+            if (reflected < low)
+            {
+                // Expansion
+                affine(value_t(2), _trial);
+                value_t expanded{evaluate(_trial.data())};
+                if (expanded < reflected)
+                    replaceWorst(_trial, expanded);
+                else
+                    replaceWorst(_reflected, reflected);
+                continue;
+            }
+
+            // Contraction
+            affine(value_t(-0.5), _trial);
+            value_t contracted{evaluate(_trial.data())};
+            if (contracted < high)
+            {
+                replaceWorst(_trial, contracted);
+                continue;
+            }
+
+            // Shrink
+            const value_t * x_low{row(_order[0])};
+            for (size_t i = 1; i <= _n; ++i)
+            {
+                value_t * x{row(_order[i])};
+                for (size_t j = 0; j < _n; ++j) x[j] = x_low[j] + (x[j] - x_low[j]) * value_t(0.5);
+            }
+            evaluateVertices(1);
+            sortSimplex();
+            sumSimplex();
+        }
+
+        _iterations = k;
+        if (num_iter) *num_iter = int(k);
+        return bestValue();
+    }
+};
+
+} // namespace My::Math
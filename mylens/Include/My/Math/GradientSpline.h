@@ -2,12 +2,14 @@
 
 #include <algorithm>
 #include <numeric>
+#include <stdexcept>
 #include <vector>
 
 #include "Math/Intervall.h"
+#include "Math/Parallel.h"
 #include "Math/QuadraticSpline.h"
 
-namespace My
+namespace My::Math
 {
 
 /**
@@ -24,6 +26,8 @@ template <typename value_t> class GradientSpline : public QuadraticSpline<value_
 private:
     bool _last{true}; // wheter the last is computed differently
 
+    std::vector<value_t> _acc; // spline value at each knot, to resume generateFrom
+
     // Constructors
 public:
     GradientSpline(size_t num_gradients,         //
@@ -50,31 +54,75 @@ public:
     GradientSpline(const GradientSpline<value_t> & o) : QuadraticSpline<value_t>(o)
     {
         _last = o._last;
+        _acc = o._acc;
     }
 
+    // Properties
 public:
-    void generate() override
+    /**
+     * @brief   Number of gradient knots (knots 1 .. numGradients()), the others hold y_0 and y_n.
+     */
+    size_t numGradients() const noexcept { return this->_knot_x.size() - (_last ? 2 : 1); }
+
+    /**
+     * @brief   Whether the spline ends in y_n.
+     */
+    bool last() const noexcept { return _last; }
+
+    // Methods
+protected:
+    void generateFrom(size_t knot) override
     {
         auto &x{this->_knot_x}, &polynom{this->_polynom};
         auto &y_0{this->_knot_y[0]}, &y_n{this->_knot_y[this->_knot_y.size() - 1]};
         auto delta{this->_delta};
         auto eta = [this](size_t i) { return i ? this->_knot_y[i] : 0; };
 
-        value_t y{y_0};
-        size_t border = x.size() - (_last ? 2 : 1);
-        for (size_t i = 1; i < border + 1; ++i)
+        if (_acc.size() != x.size())
         {
-            delta = this->_uniform ? delta : (x[i] - x[i - 1]);
+            _acc.assign(x.size(), 0);
+            knot = 0;
+        }
+        _acc[0] = y_0;
 
-            polynom[3 * (i - 1) + 0] = (eta(i) - eta(i - 1)) / (2 * delta);
-            polynom[3 * (i - 1) + 1] = (x[i - 1] * (eta(i - 1) - eta(i))) / delta + eta(i - 1);
-            polynom[3 * (i - 1) + 2] = (x[i - 1] * x[i - 1] * (eta(i) - eta(i - 1))) / (2 * delta) -
-                                       x[i - 1] * eta(i - 1) + y;
-            y = (delta * (eta(i - 1) + eta(i))) / 2 + y;
+        // gradient knot changes only touch its two polynoms, but the accumulated value moves
+        // every polynom behind them. _acc is a prefix sum of the areas below the gradient
+        // segments (see parallelScan for the tolerance of the parallel version)
+        size_t border = x.size() - (_last ? 2 : 1);
+        size_t first{std::max(knot, size_t(1))};
+        auto width = [&](size_t i) { return this->_uniform ? delta : (x[i] - x[i - 1]); };
+
+        if (border + 1 - first < parallel_threshold)
+        {
+            for (size_t i = first; i < border + 1; ++i)
+                _acc[i] = (width(i) * (eta(i - 1) + eta(i))) / 2 + _acc[i - 1];
+        }
+        else
+        {
+            parallelFor(first, border + 1, [&](size_t b, size_t e, size_t) {
+                for (size_t i = b; i < e; ++i) _acc[i] = (width(i) * (eta(i - 1) + eta(i))) / 2;
+            });
+            _acc[first] += _acc[first - 1];
+            parallelScan(_acc.data() + first, border + 1 - first);
         }
 
+        parallelFor(first, border + 1, [&](size_t b, size_t e, size_t) {
+            for (size_t i = b; i < e; ++i)
+            {
+                value_t y{_acc[i - 1]}, delta{width(i)};
+
+                polynom[3 * (i - 1) + 0] = (eta(i) - eta(i - 1)) / (2 * delta);
+                polynom[3 * (i - 1) + 1] =
+                    (x[i - 1] * (eta(i - 1) - eta(i))) / delta + eta(i - 1);
+                polynom[3 * (i - 1) + 2] =
+                    (x[i - 1] * x[i - 1] * (eta(i) - eta(i - 1))) / (2 * delta) -
+                    x[i - 1] * eta(i - 1) + y;
+            }
+        });
+
         if (_last)
         {
+            value_t y{_acc[border]};
             size_t n = x.size() - 1;
             delta = this->_uniform ? delta : (x[n] - x[n - 1]);
 
@@ -90,10 +138,31 @@ public:
         }
     }
 
+public:
     std::shared_ptr<Spline<value_t>> copy() override
     {
         return std::make_shared<GradientSpline<value_t>>(*this);
     }
+
+    /**
+     * @brief   Not supported, the knots of a GradientSpline are no values of the curve.
+     *
+     * @throws  std::logic_error always.
+     */
+    size_t insertKnot(value_t) override
+    {
+        throw std::logic_error("GradientSpline: knots can not be inserted.");
+    }
+
+    /**
+     * @brief   Not supported, see insertKnot().
+     *
+     * @throws  std::logic_error always.
+     */
+    void removeKnot(size_t) override
+    {
+        throw std::logic_error("GradientSpline: knots can not be removed.");
+    }
 };
 
 } // namespace My
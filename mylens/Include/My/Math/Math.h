@@ -1,10 +1,27 @@
 #pragma once
 
+#include "Math/ArcLengthTable.h"
+#include "Math/CompiledSpline.h"
+#include "Math/CubicSpline.h"
 #include "Math/CurvatureSpline.h"
+#include "Math/Dual.h"
+#include "Math/FixedQuadraticSpline.h"
+#include "Math/FlatSimplexSolver.h"
 #include "Math/GradientSpline.h"
 #include "Math/Spline.h"
 #include "Math/Intervall.h"
+#include "Math/MultiStartSimplexSolver.h"
+#include "Math/Parallel.h"
 #include "Math/QuadraticSpline.h"
+#include "Math/SIMD.h"
+#include "Math/SimplexCache.h"
+#include "Math/SplineArchive.h"
+#include "Math/SplineBank.h"
+#include "Math/SplineCompression.h"
+#include "Math/SplineFitter.h"
+#include "Math/SplineTable.h"
+#include "Math/StaticSpline.h"
+#include "Math/Tridiagonal.h"
 #include "Math/SimplexFunction.h"
 #include "Math/SimplexFunctionArgument.h"
 #include "Math/SimplexPair.h"
@@ -0,0 +1,219 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "Math/FlatSimplexSolver.h"
+#include "Math/Parallel.h"
+
+namespace My::Math
+{
+
+/**
+ * @brief   Statistics of one run of a @ref MultiStartSimplexSolver.
+ *
+ * @ingroup Math
+ */
+template <typename value_t> struct SimplexRun
+{
+    std::vector<value_t> start;
+    value_t value{0}; // best value reached
+    size_t iterations{0}, evaluations{0};
+    bool cancelled{false}; // stopped as hopeless before convergence
+};
+
+/**
+ * @brief   Runs several @ref FlatSimplexSolver from different start points concurrently and
+ *          returns the best optimum they find, against the local optima a single run gets stuck
+ *          in.
+ *
+ * Run 0 starts at init_state, the others at a Latin hypercube sample of the box init_state +-
+ * radius (every coordinate hits each of the runs - 1 strata once). The runs are the tasks of a
+ * @ref ThreadPool, so with at least as many runs as threads all cores are busy; their shrinks and
+ * initializations are then evaluated on the calling thread. If the function is not
+ * FlatSimplexFunction::threadSafe() the runs are sequential.
+ *
+ * The runs share the best value found so far. Every window iterations a run compares its own
+ * best value with it and cancels itself if the gap is larger than patience times its progress
+ * over the last window, i.e. if it would need more than patience windows at its current rate to
+ * catch up. Which runs are cancelled depends on timing; with patience 0 nothing is cancelled and
+ * the result only depends on the seed.
+ *
+ * @tparam  value_t     The floating point type to operate on.
+ *
+ * @ingroup Math
+ * @author  Ronja Schnur (rschnur@students.uni-mainz.de)
+ */
+template <typename value_t> class MultiStartSimplexSolver
+{
+    // Data
+private:
+    std::shared_ptr<FlatSimplexFunction<value_t>> _function;
+    std::vector<value_t> _init_state;
+    size_t _n, _runs;
+    value_t _radius, _lambda, _tolerance;
+
+    value_t _patience{4};
+    size_t _window{0};
+    uint64_t _seed{0};
+    ThreadPool * _pool{&threadPool()};
+
+    std::vector<value_t> _best;
+    value_t _best_value{std::numeric_limits<value_t>::infinity()};
+    std::vector<SimplexRun<value_t>> _statistics;
+
+    // Constructors
+public:
+    /**
+     * @brief   Construct a @ref MultiStartSimplexSolver.
+     *
+     * @param   function    The function that is to be minimized.
+     * @param   init_state  The center of the start points (N values, copied).
+     * @param   runs        The number of runs (at least 1).
+     * @param   radius      Half the edge length of the box of start points.
+     * @param   lambda      The constant offset for initializing each simplex.
+     * @param   tolerance   The tolerance value when to stop each run.
+     */
+    MultiStartSimplexSolver(std::shared_ptr<FlatSimplexFunction<value_t>> function,
+                            Span<const value_t> init_state, size_t runs, value_t radius,
+                            value_t lambda, value_t tolerance)
+        : _function{std::move(function)}, _init_state(init_state.begin(), init_state.end()),
+          _n{init_state.size()}, _runs{std::max(runs, size_t(1))}, _radius{radius},
+          _lambda{lambda}, _tolerance{tolerance}, _best(_init_state)
+    {}
+
+    // Properties
+public:
+    size_t N() const noexcept { return _n; }
+
+    size_t runs() const noexcept { return _runs; }
+
+    /**
+     * @brief   Sets the patience of the cancellation, 0 disables it (default: 4).
+     */
+    void patience(value_t patience) noexcept { _patience = patience; }
+
+    /**
+     * @brief   Sets the iterations between cancellation checks (default: 0 = 10 (N + 1)).
+     */
+    void window(size_t window) noexcept { _window = window; }
+
+    /**
+     * @brief   Sets the seed of the start points (default: 0).
+     */
+    void seed(uint64_t seed) noexcept { _seed = seed; }
+
+    /**
+     * @brief   Sets the pool running the runs (default: threadPool()).
+     */
+    void pool(ThreadPool & pool) noexcept { _pool = &pool; }
+
+    Span<const value_t> best() const { return _best; }
+
+    value_t bestValue() const noexcept { return _best_value; }
+
+    /**
+     * @brief   The statistics of every run of the last solve(), in the order of the runs.
+     */
+    const std::vector<SimplexRun<value_t>> & statistics() const noexcept { return _statistics; }
+
+    // Methods
+private:
+    static void lower(std::atomic<value_t> & a, value_t v)
+    {
+        value_t current{a.load(std::memory_order_relaxed)};
+        while (v < current && !a.compare_exchange_weak(current, v, std::memory_order_relaxed)) {}
+    }
+
+public:
+    /**
+     * @brief   The start points of the runs, runs() x N values (row major).
+     */
+    std::vector<value_t> starts() const
+    {
+        std::vector<value_t> x(_runs * _n);
+        std::copy(_init_state.begin(), _init_state.end(), x.begin());
+
+        size_t m{_runs - 1};
+        std::mt19937_64 random{_seed};
+        std::uniform_real_distribution<value_t> uniform{value_t(0), value_t(1)};
+        std::vector<size_t> strata(m);
+        for (size_t j = 0; j < _n; ++j)
+        {
+            std::iota(strata.begin(), strata.end(), size_t(0));
+            std::shuffle(strata.begin(), strata.end(), random);
+            for (size_t r = 0; r < m; ++r)
+            {
+                value_t u{(value_t(strata[r]) + uniform(random)) / value_t(m)};
+                x[(r + 1) * _n + j] = _init_state[j] + _radius * (2 * u - 1);
+            }
+        }
+        return x;
+    }
+
+    /**
+     * @brief   Runs all solvers and waits for them. With the default patience (4) the runs that
+     *          are cancelled, and so the result, may vary between calls with the same seed; set
+     *          patience(0) for a reproducible result.
+     *
+     * @return  The best value found, see best() for its position and statistics() for the runs.
+     */
+    value_t solve()
+    {
+        std::vector<value_t> x{starts()};
+        std::vector<std::vector<value_t>> best(_runs);
+        _statistics.assign(_runs, SimplexRun<value_t>{});
+
+        std::atomic<value_t> global{std::numeric_limits<value_t>::infinity()};
+        size_t window{_window ? _window : 10 * (_n + 1)};
+
+        auto run = [&](size_t r) {
+            Span<const value_t> start{x.data() + r * _n, _n};
+            FlatSimplexSolver<value_t> solver(_function, start, _lambda, _tolerance);
+            solver.pool(*_pool);
+
+            value_t last{std::numeric_limits<value_t>::infinity()};
+            if (_patience > 0)
+                solver.monitor([&](size_t k, value_t value) {
+                    if (k == 0 || k % window != 0) return true;
+                    lower(global, value);
+                    value_t gap{value - global.load(std::memory_order_relaxed)};
+                    value_t progress{last - value};
+                    last = value;
+                    return !(gap > 0 && gap > _patience * progress);
+                });
+
+            value_t value{solver.solve()};
+            lower(global, value);
+
+            auto & s = _statistics[r];
+            s.start.assign(start.begin(), start.end());
+            s.value = value;
+            s.iterations = solver.iterations();
+            s.evaluations = solver.evaluations();
+            s.cancelled = solver.stopped();
+            best[r].assign(solver.best().begin(), solver.best().end());
+        };
+
+        if (_function->threadSafe())
+            _pool->run(_runs, run);
+        else
+            for (size_t r = 0; r < _runs; ++r) run(r);
+
+        // lowest value, the first run on ties, independent of the order the runs finished in
+        size_t r{0};
+        for (size_t i = 1; i < _runs; ++i)
+            if (_statistics[i].value < _statistics[r].value) r = i;
+        _best = std::move(best[r]);
+        _best_value = _statistics[r].value;
+        return _best_value;
+    }
+};
+
+} // namespace My::Math
@@ -0,0 +1,263 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "Math/SIMD.h"
+
+namespace My::Math
+{
+
+/**
+ * @brief   Minimum number of elements for which the parallel algorithms use more than one
+ *          thread. Below it they run the sequential loop on the calling thread.
+ *
+ * @ingroup Math
+ */
+constexpr size_t parallel_threshold = size_t(1) << 16;
+
+/**
+ * @brief   Number of threads used by the parallel algorithms, defaults to the number of cores.
+ *          Set it before generating, not while another thread does.
+ *
+ * @ingroup Math
+ */
+inline size_t parallel_threads{std::max(size_t(std::thread::hardware_concurrency()), size_t(1))};
+
+/**
+ * @brief   Splits [begin, end) into one contiguous block per thread and calls f(block_begin,
+ *          block_end, block) for each of them. Ranges below parallel_threshold are passed to f
+ *          at once on the calling thread. f must not throw.
+ *
+ * @param   begin   First index.
+ * @param   end     Index behind the last.
+ * @param   f       Callable taking (size_t, size_t, size_t).
+ * @return  The number of blocks.
+ *
+ * @ingroup Math
+ */
+template <typename function_t> size_t parallelFor(size_t begin, size_t end, function_t && f)
+{
+    size_t n{end > begin ? end - begin : 0};
+    size_t blocks{n < parallel_threshold ? 1 : std::min(parallel_threads, n)};
+    if (blocks == 1)
+    {
+        if (n) f(begin, end, size_t(0));
+        return n ? 1 : 0;
+    }
+
+    size_t chunk{(n + blocks - 1) / blocks};
+    blocks = (n + chunk - 1) / chunk;
+
+    std::vector<std::thread> threads;
+    threads.reserve(blocks - 1);
+    for (size_t k = 1; k < blocks; ++k)
+    {
+        size_t b{begin + k * chunk}, e{std::min(b + chunk, end)};
+        threads.emplace_back([&f, b, e, k]() { f(b, e, k); });
+    }
+    f(begin, std::min(begin + chunk, end), size_t(0));
+    for (auto & t : threads) t.join();
+    return blocks;
+}
+
+/**
+ * @brief   In-place lagged inclusive prefix sum, data[i] += data[i - lag] for i = lag .. n - 1
+ *          (for lag = 1 the ordinary prefix sum, for lag = 2 one prefix sum over the even and one
+ *          over the odd indices).
+ *
+ * Each thread scans its own block, the block totals are combined sequentially and added back in
+ * parallel with SIMD (see @ref Batch). The sums are reassociated at the block borders, so the
+ * result differs from the sequential loop by rounding only: both are bounded by
+ * n * eps * sum|data[i]| and agree to a few ulps of that sum in practice.
+ *
+ * @param   data    Pointer to n values.
+ * @param   n       The number of values.
+ * @param   lag     The distance of the summed elements, at least 1.
+ *
+ * @ingroup Math
+ */
+template <typename value_t> void parallelScan(value_t * data, size_t n, size_t lag = 1)
+{
+    if (n < parallel_threshold || parallel_threads == 1)
+    {
+        for (size_t i = lag; i < n; ++i) data[i] += data[i - lag];
+        return;
+    }
+
+    size_t chunk{(n + parallel_threads - 1) / parallel_threads};
+    std::vector<value_t> carry((n + chunk - 1) / chunk * lag, value_t(0));
+
+    // local scans, carry holds the block totals per residue i % lag
+    parallelFor(0, n, [&](size_t b, size_t e, size_t k) {
+        for (size_t i = b + lag; i < e; ++i) data[i] += data[i - lag];
+        for (size_t i = std::max(b, e - std::min(e - b, lag)); i < e; ++i)
+            carry[k * lag + i % lag] = data[i];
+    });
+
+    // exclusive scan of the block totals, carry then holds the offset of each block
+    std::vector<value_t> offset(lag, value_t(0));
+    for (size_t k = 0; k < carry.size() / lag; ++k)
+        for (size_t r = 0; r < lag; ++r)
+        {
+            value_t total{carry[k * lag + r]};
+            carry[k * lag + r] = offset[r];
+            offset[r] += total;
+        }
+
+    parallelFor(0, n, [&](size_t b, size_t e, size_t k) {
+        using batch_t = Batch<value_t>;
+        constexpr size_t W = batch_t::width;
+        const value_t * o{carry.data() + k * lag};
+        if (k == 0) return;
+
+        size_t i{b};
+        if (W % lag == 0) // the offsets repeat within a register
+        {
+            value_t pattern[W];
+            for (size_t j = 0; j < W; ++j) pattern[j] = o[(b + j) % lag];
+            batch_t p{batch_t::load(pattern)};
+            for (; i + W <= e; i += W) (batch_t::load(data + i) + p).store(data + i);
+        }
+        for (; i < e; ++i) data[i] += o[i % lag];
+    });
+}
+
+/**
+ * @brief   Fixed set of worker threads running batches of independent tasks, for work that is
+ *          too coarse for parallelFor() (a few expensive calls instead of many cheap elements)
+ *          and too frequent to start threads for every batch.
+ *
+ * run() wakes all workers, the tasks are claimed one by one by the workers and the calling
+ * thread, and it returns when all of them are done. Only one batch runs at a time: a run() that
+ * finds the pool busy (e.g. called from inside a task) executes its tasks on the calling thread.
+ *
+ * @ingroup Math
+ * @author  Ronja Schnur (rschnur@students.uni-mainz.de)
+ */
+class ThreadPool
+{
+    // Data
+private:
+    std::vector<std::thread> _workers;
+    std::mutex _mutex;
+    std::condition_variable _wake, _done;
+    std::atomic<bool> _busy{false};
+
+    // current batch, written under _mutex before _generation changes
+    void (*_call)(void *, size_t){nullptr};
+    void * _context{nullptr};
+    size_t _count{0}, _pending{0}, _generation{0};
+    std::atomic<size_t> _next{0};
+    bool _stop{false};
+
+    // Constructors
+public:
+    /**
+     * @brief   Creates threads - 1 workers, the thread calling run() is the last one.
+     */
+    explicit ThreadPool(size_t threads = parallel_threads)
+    {
+        for (size_t i = 1; i < threads; ++i) _workers.emplace_back([this]() { work(); });
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool & operator=(const ThreadPool &) = delete;
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock{_mutex};
+            _stop = true;
+        }
+        _wake.notify_all();
+        for (auto & t : _workers) t.join();
+    }
+
+    // Properties
+public:
+    /**
+     * @brief   The number of threads running a batch, including the calling one.
+     */
+    size_t size() const noexcept { return _workers.size() + 1; }
+
+    // Methods
+private:
+    void drain(void (*call)(void *, size_t), void * context, size_t count)
+    {
+        for (size_t i; (i = _next.fetch_add(1, std::memory_order_relaxed)) < count;)
+            call(context, i);
+    }
+
+    void work()
+    {
+        size_t generation{0};
+        std::unique_lock<std::mutex> lock{_mutex};
+        while (true)
+        {
+            _wake.wait(lock, [&]() { return _stop || _generation != generation; });
+            if (_stop) return;
+            generation = _generation;
+            auto call{_call};
+            void * context{_context};
+            size_t count{_count};
+
+            lock.unlock();
+            drain(call, context, count);
+            lock.lock();
+            if (--_pending == 0) _done.notify_one();
+        }
+    }
+
+public:
+    /**
+     * @brief   Calls f(i) for i = 0 .. count - 1, concurrently, and returns when all calls are
+     *          done. Which thread runs which i is unspecified. f must not throw.
+     */
+    template <typename function_t> void run(size_t count, function_t && f)
+    {
+        if (count < 2 || _workers.empty() || _busy.exchange(true, std::memory_order_acquire))
+        {
+            for (size_t i = 0; i < count; ++i) f(i);
+            return;
+        }
+
+        using f_t = std::remove_reference_t<function_t>;
+        auto call = [](void * context, size_t i) { (*static_cast<f_t *>(context))(i); };
+        void * context{const_cast<void *>(static_cast<const void *>(&f))};
+        {
+            std::lock_guard<std::mutex> lock{_mutex};
+            _call = call;
+            _context = context;
+            _count = count;
+            _pending = _workers.size();
+            _next.store(0, std::memory_order_relaxed);
+            ++_generation;
+        }
+        _wake.notify_all();
+        drain(call, context, count);
+
+        std::unique_lock<std::mutex> lock{_mutex};
+        _done.wait(lock, [&]() { return _pending == 0; });
+        _busy.store(false, std::memory_order_release);
+    }
+};
+
+/**
+ * @brief   The ThreadPool shared by the Math module, created with parallel_threads threads on
+ *          first use.
+ *
+ * @ingroup Math
+ */
+inline ThreadPool & threadPool()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+} // namespace My::Math
@@ -1,11 +1,22 @@
 #pragma once
 
+#include <algorithm>
+#include <cassert>
+#include <cmath>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <stdexcept>
+#include <type_traits>
 #include <vector>
 
+#include "Math/ArcLengthTable.h"
+#include "Math/CompiledSpline.h"
 #include "Math/Intervall.h"
+#include "Math/Parallel.h"
+#include "Math/SIMD.h"
 #include "Math/Spline.h"
+#include "Math/SplineTable.h"
 #include "Utility/Utility.h"
 
 namespace My::Math
@@ -26,6 +37,22 @@ template <typename value_t> class QuadraticSpline : public Spline<value_t>
 protected:
     bool _uniform{true};
 
+    // search tree over _knot_x in eytzinger (bfs) order, 1-based, see generateIndex()
+    std::vector<value_t> _index_x;
+    std::vector<size_t> _index_id;
+    bool _index_dirty{true};
+
+    size_t _dirty{0};            // first knot changed since the last generation
+    std::vector<value_t> _d, _w; // scratch of generateFrom, kept to resume the recurrence
+
+    SplineTable<value_t> _table; // used by compute() if _table_error > 0, see tabulate()
+    value_t _table_error{0};
+
+    std::vector<value_t> _area; // integral from the first knot to each knot, see antiderivative()
+
+    std::vector<value_t> _inverse; // a, slope, value and x at each knot, see generateInverse()
+    value_t _inverse_sign{1};
+
     // CONSTRUCTORS
 public:
     /**
@@ -48,7 +75,7 @@ public:
      * @param   knot_y   y-Knot Values
      */
     QuadraticSpline(std::initializer_list<value_t> knot_x, std::initializer_list<value_t> knot_y)
-        : Spline<value_t>(knot_x.size(), Intervall<value_t>{*knot_x.begin(), *knot_x.end()}),
+        : Spline<value_t>(knot_x.size(), Intervall<value_t>{*knot_x.begin(), *(knot_x.end() - 1)}),
           _uniform{false}
     {
         this->_polynom =
@@ -64,7 +91,7 @@ public:
      * @param   knot_y   y-Knot Values
      */
     QuadraticSpline(std::vector<value_t> knot_x, std::vector<value_t> knot_y)
-        : Spline<value_t>(knot_x.size(), Intervall<value_t>{*knot_x.begin(), *knot_x.end()}),
+        : Spline<value_t>(knot_x.size(), Intervall<value_t>{*knot_x.begin(), *(knot_x.end() - 1)}),
           _uniform{false}
     {
         this->_polynom =
@@ -82,12 +109,16 @@ public:
      */
     QuadraticSpline(std::initializer_list<value_t> knot_x, std::initializer_list<value_t> knot_y,
                     std::initializer_list<value_t> polynom)
-        : Spline<value_t>(polynom.size() / 3, Intervall<value_t>{0, 0}), _uniform{false}
+        : Spline<value_t>(polynom.size() / 3 + 1,
+                          Intervall<value_t>{*knot_x.begin(), *(knot_x.end() - 1)}),
+          _uniform{false}
     {
         this->_polynom = std::vector<value_t>(polynom.size());
         std::copy(knot_x.begin(), knot_x.end(), this->_knot_x.begin());
         std::copy(knot_y.begin(), knot_y.end(), this->_knot_y.begin());
         std::copy(polynom.begin(), polynom.end(), this->_polynom.begin());
+        generateIndex();
+        _dirty = this->numKnots(); // coefficients are given, no scratch: next update is full
     }
 
     /**
@@ -99,18 +130,27 @@ public:
      */
     QuadraticSpline(std::vector<value_t> knot_x, std::vector<value_t> knot_y,
                     std::vector<value_t> polynom)
-        : Spline<value_t>(polynom.size() / 3, Intervall<value_t>{0, 0}), _uniform{false}
+        : Spline<value_t>(polynom.size() / 3 + 1,
+                          Intervall<value_t>{*knot_x.begin(), *(knot_x.end() - 1)}),
+          _uniform{false}
     {
         this->_polynom = std::vector<value_t>(polynom.size());
         std::copy(knot_x.begin(), knot_x.end(), this->_knot_x.begin());
         std::copy(knot_y.begin(), knot_y.end(), this->_knot_y.begin());
         std::copy(polynom.begin(), polynom.end(), this->_polynom.begin());
+        generateIndex();
+        _dirty = this->numKnots(); // coefficients are given, no scratch: next update is full
     }
 
-    QuadraticSpline(const QuadraticSpline<value_t> & o) : Spline<value_t>(o) {}
+    QuadraticSpline(const QuadraticSpline<value_t> & o)
+        : Spline<value_t>(o), _uniform{o._uniform}, _index_x(o._index_x), _index_id(o._index_id),
+          _index_dirty{o._index_dirty}, _dirty{o._dirty}, _d(o._d), _w(o._w), _table(o._table),
+          _table_error{o._table_error}, _area(o._area), _inverse(o._inverse),
+          _inverse_sign{o._inverse_sign}
+    {}
 
     // METHODS
-private:
+protected:
     /**
      * @brief   Evaluates i-th-spline-polynom within the spline.
      *          Execute QuadraticSpline::generate before usage.
@@ -118,7 +158,7 @@ private:
      * @param   i   Which polynom.
      * @param   x   Function argument.
      */
-    value_t polynomial(size_t i, value_t x)
+    value_t polynomial(size_t i, value_t x) const
     {
         if ((i * 3) < this->_polynom.size())
         {
@@ -127,23 +167,315 @@ private:
                    this->_polynom[i * 3 + 2];      //
         }
         else
-            return this->_knot_y[this->_knot_y.size() - 1];
+            return tail();
     }
 
-    value_t polynomial_derivative(size_t i, value_t x)
+    value_t polynomial_derivative(size_t i, value_t x) const
     {
-        if ((i * 3) < this->_polynom.size())
+        i = std::min(i, this->_knot_x.size() - 2); // last polynom continues behind the intervall
+        return 2 * this->_polynom[i * 3] * x + //
+               this->_polynom[i * 3 + 1];
+    }
+
+    /**
+     * @brief   The value returned behind the last knot: the last polynom at the last knot.
+     */
+    value_t tail() const
+    {
+        size_t i{(this->_knot_x.size() - 2) * 3};
+        value_t x{this->_knot_x[this->_knot_x.size() - 1]};
+        return this->_polynom[i] * x * x + this->_polynom[i + 1] * x + this->_polynom[i + 2];
+    }
+
+    /**
+     * @brief   Integral of the i-th polynom from its knot to x, in local coordinates t = x - x_i
+     *          so that it does not cancel far away from the origin. Behind the intervall the
+     *          spline is constant (see tail()).
+     */
+    value_t area(size_t i, value_t x) const
+    {
+        const auto & k{this->_knot_x};
+        value_t t{x - k[i]};
+        if (i >= k.size() - 1) return tail() * t;
+
+        const value_t *p{this->_polynom.data() + 3 * i}, x_i{k[i]};
+        value_t f{(p[0] * x_i + p[1]) * x_i + p[2]}, df{2 * p[0] * x_i + p[1]};
+        return t * (f + t * (df / 2 + t * p[0] / 3));
+    }
+
+    /**
+     * @brief   Recomputes the cumulative integrals behind knot.
+     */
+    void generateArea(size_t knot)
+    {
+        const auto & x{this->_knot_x};
+        if (_area.size() != x.size())
+        {
+            _area.assign(x.size(), 0);
+            knot = 0;
+        }
+
+        size_t first{std::max(knot, size_t(1))};
+        parallelFor(first, x.size(), [&](size_t b, size_t e, size_t) {
+            for (size_t i = b; i < e; ++i) _area[i] = area(i - 1, x[i]);
+        });
+        _area[first] += _area[first - 1];
+        parallelScan(_area.data() + first, x.size() - first);
+    }
+
+    /**
+     * @brief   Computes the coefficients of the i-th polynom from the slopes _w at its knots.
+     */
+    void generatePolynom(size_t i)
+    {
+        const auto &x{this->_knot_x}, &y{this->_knot_y};
+        auto & p{this->_polynom};
+        auto id = i * 3;
+
+        // quadratic coefficient
+        p[id] = 0.5 * (_w[i + 1] - _w[i]) / (x[i + 1] - x[i]);
+        // linear coefficient
+        p[id + 1] = _w[i] - 2 * p[id] * x[i];
+        // constant coefficient
+        p[id + 2] = p[id] * x[i] * x[i] - _w[i] * x[i] + y[i];
+    }
+
+    /**
+     * @brief   Rebuilds the table of inverse(): per knot the quadratic coefficient and the slope
+     *          of its polynom and the value and position of the knot. Slopes and values are
+     *          multiplied by _inverse_sign, so a falling spline is searched as a rising one.
+     *
+     * @param   knot    The first changed knot, the entries from its polynom on are rebuilt (all
+     *                  of them if the size or _inverse_sign changed).
+     */
+    void generateInverse(size_t knot)
+    {
+        const auto & x{this->_knot_x};
+        size_t n{x.size()};
+        value_t sign{tail() < polynomial(0, x[0]) ? value_t(-1) : value_t(1)};
+        if (_inverse.size() != 4 * n || sign != _inverse_sign) knot = 0;
+        _inverse.resize(4 * n);
+        _inverse_sign = sign;
+
+        size_t first{std::min(knot > 0 ? knot - 1 : 0, n - 1)};
+        parallelFor(first, n - 1, [&](size_t b, size_t e, size_t) {
+            for (size_t i = b; i < e; ++i)
+            {
+                const value_t * p{this->_polynom.data() + 3 * i};
+                _inverse[4 * i + 0] = _inverse_sign * p[0];
+                _inverse[4 * i + 1] = _inverse_sign * (2 * p[0] * x[i] + p[1]);
+                _inverse[4 * i + 2] = _inverse_sign * polynomial(i, x[i]);
+                _inverse[4 * i + 3] = x[i];
+            }
+        });
+        _inverse[4 * (n - 1) + 0] = 0;
+        _inverse[4 * (n - 1) + 1] = 0;
+        _inverse[4 * (n - 1) + 2] = _inverse_sign * tail();
+        _inverse[4 * (n - 1) + 3] = x[n - 1];
+    }
+
+    /**
+     * @brief   Rebuilds the search tree used by segment() for non-uniform knots. The knots are
+     *          stored in eytzinger order, so a lookup is a fixed number of branchless steps
+     *          walking down an implicit binary tree whose top levels share cache lines.
+     */
+    void generateIndex()
+    {
+        _index_dirty = false;
+        if (_uniform) return;
+
+        size_t n{this->_knot_x.size()};
+        _index_x.resize(n + 1);
+        _index_id.resize(n + 1);
+
+        size_t i{0};
+        auto fill = [&](auto & self, size_t k) -> void {
+            if (k > n) return;
+            self(self, 2 * k);
+            _index_x[k] = this->_knot_x[i];
+            _index_id[k] = i++;
+            self(self, 2 * k + 1);
+        };
+        fill(fill, 1);
+    }
+
+    /**
+     * @brief   Finds the polynom responsible for value. Values in front of the intervall map to
+     *          the first polynom, values behind it to numKnots() - 1 (see tail()).
+     *
+     * @param   value   X value to look up.
+     */
+    size_t segment(value_t value) const
+    {
+        const auto & x{this->_knot_x};
+        if (!(value > x[0])) return 0;
+        if (_uniform) return std::min(size_t((value - x[0]) / this->_delta), x.size() - 1);
+
+        // descend to the first knot > value
+        size_t n{x.size()}, k{1};
+        while (k <= n) k = 2 * k + size_t(!(value < _index_x[k]));
+        while (k & 1) k >>= 1; // leave all right turns taken at the bottom ...
+        k >>= 1;               // ... and the last left one
+
+        return k ? _index_id[k] - 1 : n - 1;
+    }
+
+    /**
+     * @brief   Like segment(value_t) but first tries the polynom at hint and its successor, which
+     *          is O(1) for monotone sweeps over the spline.
+     *
+     * @param   value   X value to look up.
+     * @param   hint    The last segment, is updated to the new one.
+     */
+    size_t segment(value_t value, size_t & hint) const
+    {
+        const auto & x{this->_knot_x};
+        size_t n{x.size()};
+        if (!_uniform && hint < n - 1 && !(value < x[hint]))
+        {
+            if (value < x[hint + 1]) return hint;
+            if (hint + 2 >= n || value < x[hint + 2]) return ++hint;
+        }
+        return hint = segment(value);
+    }
+
+    /**
+     * @brief   Batched evaluation of the spline or its derivative, see compute(const value_t *,
+     *          value_t *, size_t).
+     */
+    template <bool derivative_v>
+    void evaluateBatch(const value_t * xs, value_t * out, size_t n) const
+    {
+        using batch_t = Batch<value_t>;
+        constexpr size_t W = batch_t::width;
+
+        const value_t * p{this->_polynom.data()};
+        const int32_t segments = int32_t(this->_knot_x.size() - 1);
+        const batch_t start{batch_t::broadcast(this->_intervall._start)};
+        const batch_t delta{batch_t::broadcast(this->_delta)};
+        const batch_t last{batch_t::broadcast(value_t(segments))};
+        const batch_t end{batch_t::broadcast(tail())};
+        const batch_t two{batch_t::broadcast(2)};
+
+        value_t x_buffer[W], t_buffer[W], out_buffer[W];
+        int32_t id[W];
+        size_t hint{0};
+
+        for (size_t i = 0; i < n; i += W)
         {
-            return this->_polynom[i * 3] * x + //
-                   this->_polynom[i * 3 + 1];
+            // pad the remainder, so there is only one code path
+            size_t m = std::min(W, n - i);
+            const value_t * x_ptr{xs + i};
+            if (m < W)
+            {
+                std::fill(x_buffer, x_buffer + W, this->_intervall._start);
+                std::copy(xs + i, xs + n, x_buffer);
+                x_ptr = x_buffer;
+            }
+
+            batch_t x{batch_t::load(x_ptr)}, t;
+            if (_uniform)
+                t = (x - start) / delta;
+            else
+            {
+                for (size_t k = 0; k < W; ++k) t_buffer[k] = value_t(segment(x_ptr[k], hint));
+                t = batch_t::load(t_buffer);
+            }
+
+            batch_t::indices(t, segments - 1, 3, id);
+            batch_t a{batch_t::gather(p, id)};
+            for (size_t k = 0; k < W; ++k) id[k] += 1;
+            batch_t b{batch_t::gather(p, id)};
+
+            batch_t r;
+            if constexpr (derivative_v)
+                r = two * a * x + b;
+            else
+            {
+                for (size_t k = 0; k < W; ++k) id[k] += 1;
+                r = (a * x + b) * x + batch_t::gather(p, id);
+                r = batch_t::selectGreaterEqual(t, last, end, r);
+            }
+
+            if (m < W)
+            {
+                r.store(out_buffer);
+                std::copy(out_buffer, out_buffer + m, out + i);
+            }
+            else
+                r.store(out + i);
+        }
+    }
+
+protected:
+    /**
+     * @brief   Computes the coefficients of all polynoms affected by changes of knot and its
+     *          successors. Subclasses with a different construction override this instead of
+     *          generate(); they may always regenerate everything.
+     *
+     * @param   knot    The first changed knot.
+     */
+    virtual void generateFrom(size_t knot)
+    {
+        auto &x{this->_knot_x}, &y{this->_knot_y};
+        size_t n{x.size()};
+
+        if (_w.size() != n) // no state to resume from
+        {
+            _d.assign(n, 0); // d[0] = 0
+            _w.assign(n, 0); // z[0] = d[0] = 0
+            knot = 0;
+        }
+
+        // d[knot] and d[knot + 1] changed, which changes every w[i >= knot] and with them every
+        // polynom from knot - 1 on
+        size_t first{std::max(knot, size_t(1))};
+
+        parallelFor(first, n, [&](size_t b, size_t e, size_t) {
+            for (size_t i = b; i < e; ++i) _d[i] = 2 * (y[i] - y[i - 1]) / (x[i] - x[i - 1]);
+        });
+
+        // solve linear equation system, w[i] = (d[i] - d[i - 1]) + w[i - 2] is a prefix sum over
+        // every second element (see parallelScan for the tolerance of the parallel version)
+        if (n - first < parallel_threshold)
+        {
+            for (size_t i = first; i < n; i++)
+            {
+                _w[i] = _d[i];
+                _w[i] -= _d[i - 1];
+                _w[i] += (i > 1) ? _w[i - 2] : 0;
+            }
         }
         else
         {
-            return this->_polynom[(this->_knot_x.size() - 1) * 3] * x + //
-                   this->_polynom[(this->_knot_x.size() - 1) * 3 + 1];
+            parallelFor(first, n, [&](size_t b, size_t e, size_t) {
+                for (size_t i = b; i < e; ++i) _w[i] = _d[i] - _d[i - 1];
+            });
+            if (first > 1) _w[first] += _w[first - 2];
+            _w[first + 1] += _w[first - 1];
+            parallelScan(_w.data() + first, n - first, 2);
         }
+
+        // compute coefficients
+        parallelFor(first, n, [&](size_t b, size_t e, size_t) {
+            for (size_t i = b; i < e; i++) generatePolynom(i - 1);
+        });
     }
 
+    /**
+     * @brief   Rebuilds the table of tabulate() from the current polynoms, called by update().
+     */
+    void generateTable()
+    {
+        _table.build(this->_knot_x.data(), this->_polynom.data(), this->_knot_x.size(),
+                     _table_error);
+    }
+
+    /**
+     * @brief   Marks knot and everything behind it for regeneration on the next update().
+     */
+    void invalidate(size_t knot) override { _dirty = std::min(_dirty, knot); }
+
 public:
     /**
      * @brief   Specify knot y-value
@@ -151,90 +483,491 @@ public:
      * @param   knot    ID which knot is being changed.
      * @param   value   The new y-value for the knot.
      */
-    void specify(size_t knot, value_t value) override { this->_knot_y[knot] = value; }
+    void specify(size_t knot, value_t value) override
+    {
+        this->_knot_y[knot] = value;
+        invalidate(knot);
+    }
 
     void specifyX(size_t knot, value_t value) override
     {
         _uniform = false;
+        _index_dirty = true;
         this->_knot_x[knot] = value;
         if (knot == 0) this->_intervall._start = value;
         if (knot == this->_knot_x.size() - 1) this->_intervall._end = value;
+        invalidate(knot);
     }
 
-    void generate() override
+    /**
+     * @brief   Inserts a knot at x on the current curve, so the spline does not change. Only the
+     *          polynom containing x is split, every other polynom and all cached integrals are
+     *          kept (a quadratic through a point on itself keeps its slopes at both ends).
+     *          Afterwards the new knot can be moved with specify() like any other.
+     *
+     *          Subclasses whose y-knots are no values (GradientSpline, CurvatureSpline) override
+     *          it to throw std::logic_error.
+     *
+     * @param   x   Position of the new knot, strictly inside the intervall.
+     *
+     * @return  The ID of the new knot (or of the knot already at x).
+     *
+     * @throws  std::out_of_range if x is not inside the intervall.
+     */
+    virtual size_t insertKnot(value_t x)
     {
-        std::vector<value_t> d(this->_knot_x.size()); // size N
-        std::vector<value_t> w(this->_knot_x.size()); // size N
+        auto &k{this->_knot_x}, &y{this->_knot_y};
+        if (!(x > k.front() && x < k.back()))
+            throw std::out_of_range("QuadraticSpline: knot outside of the intervall.");
 
-        for (size_t i = 1; i < d.size(); ++i) // d[0] = 0
-        {
-            d[i] = 2 * (this->_knot_y[i] - this->_knot_y[i - 1]) /
-                   (this->_knot_x[i] - this->_knot_x[i - 1]);
-        }
+        update();
+        size_t j{segment(x)}, n{k.size()};
+        if (k[j] == x) return j;
 
-        // solve linear equation system
-        for (size_t i = 1; i < d.size(); i++) // z[0] = d[0] = 0
-        {
-            w[i] = d[i];
-            w[i] -= d[i - 1];
-            w[i] += (i > 1) ? w[i - 2] : 0;
-        }
+        value_t v{polynomial(j, x)};
+        const auto & p{this->_polynom};
+        value_t a{p[3 * j]}, b{p[3 * j + 1]}, c{p[3 * j + 2]}; // split polynom, see check below
+        k.insert(k.begin() + (j + 1), x);
+        y.insert(y.begin() + (j + 1), v);
+        this->_polynom.insert(this->_polynom.begin() + 3 * (j + 1), 3, 0);
+        _uniform = false;
+        generateIndex();
 
-        // compute coefficients
-        for (size_t i = 1; i < this->_knot_x.size(); i++)
+        if (_w.size() == n) // continue the recurrence over the split polynom
         {
-            auto id = (i - 1) * 3;
-            auto &x{this->_knot_x}, &y{this->_knot_y}, &p{this->_polynom};
-
-            // quadratic coefficient
-            p[id] = 0.5 * (w[i] - w[i - 1]) / (x[i] - x[i - 1]);
-            // linear coefficient
-            p[id + 1] = w[i - 1] - 2 * p[id] * x[i - 1];
-            // constant coefficient
-            p[id + 2] = p[id] * x[i - 1] * x[i - 1] - w[i - 1] * x[i - 1] + y[i - 1];
+            _d.insert(_d.begin() + (j + 1), 2 * (v - y[j]) / (x - k[j]));
+            _d[j + 2] = 2 * (y[j + 2] - v) / (k[j + 2] - x);
+            _w.insert(_w.begin() + (j + 1), _d[j + 1] - _d[j] + (j > 0 ? _w[j - 1] : 0));
+            generatePolynom(j);
+            generatePolynom(j + 1);
+            _dirty = n + 1;
+
+            if constexpr (std::is_floating_point_v<value_t>) // both halves follow the old curve
+            {
+                auto unchanged = [&](size_t i, value_t t) {
+                    value_t expected{(a * t + b) * t + c};
+                    value_t tolerance{std::sqrt(std::numeric_limits<value_t>::epsilon()) *
+                                      (1 + std::abs(expected))};
+                    return std::abs(polynomial(i, t) - expected) <= tolerance;
+                };
+                (void)unchanged;
+                assert(unchanged(j, (k[j] + x) / 2) && unchanged(j + 1, (x + k[j + 2]) / 2));
+            }
+
+            if (_area.size() == n)
+            {
+                _area.insert(_area.begin() + (j + 1), _area[j] + area(j, x));
+                _area[j + 2] = _area[j + 1] + area(j + 1, k[j + 2]);
+            }
+            if (_table_error > 0) generateTable();
         }
+        else
+            _dirty = j;
+        return j + 1;
     }
 
-    value_t compute(value_t value) override
+    /**
+     * @brief   Removes an inner knot, merging its two polynoms. The polynoms in front of the
+     *          merged one are kept. The ones behind it change as well (the slope of the merged
+     *          polynom at its end is fixed by its knots and passed on by the recurrence), they are
+     *          regenerated incrementally by the next update().
+     *
+     * @param   knot    The ID of the knot, 0 < knot < numKnots() - 1.
+     *
+     * @throws  std::out_of_range if knot is no inner knot.
+     */
+    virtual void removeKnot(size_t knot)
     {
-        if (_uniform)
+        auto &k{this->_knot_x}, &y{this->_knot_y};
+        size_t n{k.size()};
+        if (knot == 0 || knot >= n - 1)
+            throw std::out_of_range("QuadraticSpline: only inner knots can be removed.");
+
+        k.erase(k.begin() + knot);
+        y.erase(y.begin() + knot);
+        auto & p{this->_polynom};
+        p.erase(p.begin() + 3 * knot, p.begin() + 3 * (knot + 1));
+        if (_w.size() == n) // keep the scratch in front of knot to resume from
         {
-            size_t i{size_t((value - this->_intervall._start) / this->_delta)};
-            return polynomial(i, value);
+            _d.erase(_d.begin() + knot);
+            _w.erase(_w.begin() + knot);
         }
-        else
+        if (_area.size() == n) _area.erase(_area.begin() + knot);
+
+        _uniform = false;
+        _index_dirty = true;
+        _dirty = std::min(_dirty, knot);
+    }
+
+    /**
+     * @brief   Adaptively refines the spline towards f until it is within max_error of it. Each
+     *          pass samples every polynom at a quarter, half and three quarters of its width,
+     *          splits the ones off by more than max_error at their middle (see insertKnot()) and
+     *          moves the new knots onto f, followed by a single incremental update().
+     *
+     *          The spline should interpolate f at its knots when called. As it starts with slope
+     *          0 at the first knot, the error converges slowly if the slope of f is not 0 there.
+     *          Like insertKnot() it throws std::logic_error for GradientSpline and
+     *          CurvatureSpline.
+     *
+     * @param   f           The function to approximate, value_t(value_t).
+     * @param   max_error   The target maximum absolute error.
+     * @param   max_knots   Stops when this number of knots is reached.
+     *
+     * @return  The largest sampled error of the last pass.
+     */
+    template <typename function_t>
+    value_t refine(function_t && f, value_t max_error, size_t max_knots)
+    {
+        std::vector<value_t> split;
+        std::vector<size_t> ids;
+
+        while (true)
         {
-            size_t id = 0;
-            while (!(this->_knot_x[id] <= value && value < this->_knot_x[id + 1]) &&
-                   id < this->_knot_x.size())
+            update();
+            const auto & k{this->_knot_x};
+            value_t error{0};
+            split.clear();
+
+            for (size_t i = 0; i < k.size() - 1; ++i)
             {
-                id++;
+                value_t h{k[i + 1] - k[i]}, e{0};
+                for (value_t t : {value_t(0.25), value_t(0.5), value_t(0.75)})
+                {
+                    value_t x{k[i] + t * h};
+                    using std::abs;
+                    e = std::max(e, value_t(abs(f(x) - polynomial(i, x))));
+                }
+                error = std::max(error, e);
+                if (e > max_error && k[i] + h / 2 > k[i]) split.push_back(k[i] + h / 2);
             }
 
-            return polynomial(id, value);
+            size_t count{std::min(split.size(), max_knots - std::min(max_knots, k.size()))};
+            if (count == 0) return error;
+
+            // right to left, so the IDs of the knots already inserted only shift by one per knot
+            ids.resize(count);
+            for (size_t c = count; c-- > 0;) ids[c] = insertKnot(split[c]);
+            for (size_t c = 0; c < count; ++c) specify(ids[c] + c, f(split[c]));
         }
     }
 
-    value_t derivative(value_t value)
+    /**
+     * @brief   Whether the knots are equally distributed.
+     */
+    bool uniform() const noexcept { return _uniform; }
+
+    /**
+     * @brief   Access the lookup table used by compute() (empty if not tabulated).
+     */
+    const SplineTable<value_t> & table() const noexcept { return _table; }
+
+    /**
+     * @brief   Lets compute() evaluate a dense lookup table instead of the polynoms. The table is
+     *          sized so that its error stays below max_error (see @ref SplineTable) and is
+     *          rebuilt by every generation. evaluate() and derivative() stay exact.
+     *
+     * @param   max_error   The maximum absolute error, 0 disables the table.
+     */
+    void tabulate(value_t max_error)
+    {
+        _table_error = max_error;
+        if (!(max_error > 0))
+            _table.clear();
+        else if (!dirty())
+            generateTable();
+    }
+
+    /**
+     * @brief   Whether knots changed since the last generation.
+     */
+    bool dirty() const noexcept { return _dirty < this->_knot_x.size(); }
+
+    /**
+     * @brief   Regenerates the polynoms touched by specify()/specifyX() since the last
+     *          generation, reusing the scratch buffers. compute() and derivative() call it
+     *          implicitly; the const evaluate() functions do not.
+     */
+    void update()
+    {
+        if (!dirty()) return;
+        if (_index_dirty) generateIndex();
+        generateFrom(_dirty);
+        if (!_area.empty()) generateArea(_dirty);
+        if (!_inverse.empty()) generateInverse(_dirty);
+        _dirty = this->_knot_x.size();
+        if (_table_error > 0) generateTable();
+    }
+
+    /**
+     * @brief   Computes all polynom coefficients. Splines with at least parallel_threshold knots
+     *          are generated on all cores (see @ref parallelScan).
+     */
+    void generate() override
+    {
+        _dirty = 0;
+        update();
+    }
+
+    /**
+     * @brief   Non-virtual evaluation of the spline. Prefer it over compute() in tight loops where
+     *          the spline type is known, as it can be inlined (see @ref StaticSpline).
+     *
+     * @param   value   X value to compute.
+     *
+     * @return The function value.
+     */
+    value_t evaluate(value_t value) const { return polynomial(segment(value), value); }
+
+    /**
+     * @brief   Non-virtual evaluation of the derivative, see evaluate().
+     */
+    value_t evaluateDerivative(value_t value) const
+    {
+        return polynomial_derivative(segment(value), value);
+    }
+
+    value_t compute(value_t value) override
+    {
+        update();
+        return _table.empty() ? evaluate(value) : _table(value);
+    }
+
+    /**
+     * @brief   Computes the spline at value, starting the segment search at hint. Use it for
+     *          (mostly) monotone sweeps over non-uniform splines.
+     *
+     * @param   value   X value to compute.
+     * @param   hint    Segment of the previous call (initialize with 0), is updated.
+     *
+     * @return The function value.
+     */
+    value_t compute(value_t value, size_t & hint)
+    {
+        update();
+        return _table.empty() ? polynomial(segment(value, hint), value) : _table(value);
+    }
+
+    /**
+     * @brief   Computes the spline at n positions at once. Segment lookup and evaluation of the
+     *          polynoms run on SIMD registers if available (see @ref Batch).
+     *
+     * @param   xs      Pointer to n x-values.
+     * @param   out     Pointer to n results.
+     * @param   n       The number of values.
+     */
+    void compute(const value_t * xs, value_t * out, size_t n)
+    {
+        update();
+        if (_table.empty())
+            evaluateBatch<false>(xs, out, n);
+        else
+            _table.compute(xs, out, n);
+    }
+
+    /**
+     * @brief   Non-virtual evaluation of the antiderivative, see antiderivative(). Requires an
+     *          up to date spline and a previous call of antiderivative() or integral().
+     */
+    value_t evaluateAntiderivative(value_t value) const
+    {
+        size_t i{segment(value)};
+        return _area[i] + area(i, value);
+    }
+
+    /**
+     * @brief   Exact integral of the spline from the first knot to value (negative in front of
+     *          it). The integrals up to each knot are cached and updated with the polynoms, a
+     *          query is one segment lookup.
+     *
+     * @param   value   Upper bound.
+     *
+     * @return The integral.
+     */
+    value_t antiderivative(value_t value)
     {
-        if (_uniform)
+        update();
+        if (_area.size() != this->_knot_x.size()) generateArea(0);
+        return evaluateAntiderivative(value);
+    }
+
+    /**
+     * @brief   Exact integral of the spline from a to b, see antiderivative().
+     */
+    value_t integral(value_t a, value_t b) { return antiderivative(b) - antiderivative(a); }
+
+    /**
+     * @brief   Non-virtual version of inverse(value_t). Requires an up to date spline and a
+     *          previous call of inverse().
+     */
+    value_t evaluateInverse(value_t value) const
+    {
+        const value_t * t{_inverse.data()};
+        size_t n{this->_knot_x.size()}, i{0};
+        value_t y{_inverse_sign * value};
+
+        // last knot (but the last) with a value <= y
+        size_t step{1};
+        while (2 * step <= n - 2) step *= 2;
+        for (; step > 0; step /= 2)
         {
-            size_t i{size_t((value - this->_intervall._start) / this->_delta)};
-            return polynomial_derivative(i, value);
+            size_t c{std::min(i + step, n - 2)};
+            if (!(y < t[4 * c + 2])) i = c;
         }
-        else
+
+        using std::sqrt; // or the overload of value_t (see @ref Dual)
+
+        // the root of a u^2 + b u + (v - y) with positive slope, u = x - x_i, in the form
+        // without cancellation; the denominator is 0 only on a flat polynom, which reaches y
+        // at its end if it lies below y
+        t += 4 * i;
+        value_t c{t[2] - y}, s{sqrt(std::max(t[1] * t[1] - 4 * t[0] * c, value_t(0)))};
+        value_t d{t[1] + s}, h{t[7] - t[3]};
+        value_t u{!(d <= value_t(0)) ? -2 * c / d : c < value_t(0) ? h : value_t(0)};
+        return t[3] + std::min(std::max(u, value_t(0)), h);
+    }
+
+    /**
+     * @brief   The position at which a monotone spline reaches value (in the intervall): the
+     *          polynom is found by a binary search over the values at the knots, then its
+     *          quadratic is solved in closed form. Values outside of the range of the spline
+     *          map to the first or last knot. The values at the knots are cached and updated
+     *          with the polynoms.
+     *
+     * @param   value   The value to reach.
+     *
+     * @return  x with spline(x) = value.
+     */
+    value_t inverse(value_t value)
+    {
+        update();
+        if (_inverse.size() != 4 * this->_knot_x.size()) generateInverse(0);
+        return evaluateInverse(value);
+    }
+
+    /**
+     * @brief   Batched version of inverse(value_t): the binary search steps and the solution run
+     *          on SIMD registers, one value per lane (see @ref Batch). Results match
+     *          inverse(value_t) up to rounding of the SIMD square root.
+     *
+     * @param   ys      Pointer to n values.
+     * @param   out     Pointer to n results.
+     * @param   n       The number of values.
+     */
+    void inverse(const value_t * ys, value_t * out, size_t n)
+    {
+        using batch_t = Batch<value_t>;
+        constexpr size_t W = batch_t::width;
+
+        update();
+        if (_inverse.size() != 4 * this->_knot_x.size()) generateInverse(0);
+
+        const value_t * t{_inverse.data()};
+        const int32_t last = int32_t(this->_knot_x.size() - 2);
+        const batch_t sign{batch_t::broadcast(_inverse_sign)}, zero{batch_t::broadcast(0)};
+        const batch_t limit{batch_t::broadcast(value_t(last))};
+        const batch_t two{batch_t::broadcast(2)}, four{batch_t::broadcast(4)};
+
+        size_t top{1};
+        while (2 * top <= size_t(last)) top *= 2;
+
+        value_t y_buffer[W], out_buffer[W];
+        int32_t id[W];
+
+        for (size_t i = 0; i < n; i += W)
         {
-            size_t id = 0;
-            while (!(this->_knot_x[id] <= value && value < this->_knot_x[id + 1]) &&
-                   id < this->_knot_x.size())
+            size_t m = std::min(W, n - i);
+            const value_t * y_ptr{ys + i};
+            if (m < W)
             {
-                id++;
+                std::fill(y_buffer, y_buffer + W, ys[i]);
+                std::copy(ys + i, ys + n, y_buffer);
+                y_ptr = y_buffer;
             }
 
-            return polynomial_derivative(id, value);
+            batch_t y{sign * batch_t::load(y_ptr)}, k{zero};
+            for (size_t step = top; step > 0; step /= 2)
+            {
+                batch_t c{batch_t::min(k + batch_t::broadcast(value_t(step)), limit)};
+                batch_t::indices(c, last, 4, id);
+                for (size_t j = 0; j < W; ++j) id[j] += 2;
+                k = batch_t::selectGreaterEqual(y, batch_t::gather(t, id), c, k);
+            }
+
+            batch_t::indices(k, last, 4, id);
+            batch_t a{batch_t::gather(t, id)};
+            for (size_t j = 0; j < W; ++j) id[j] += 1;
+            batch_t b{batch_t::gather(t, id)};
+            for (size_t j = 0; j < W; ++j) id[j] += 1;
+            batch_t c{batch_t::gather(t, id) - y};
+            for (size_t j = 0; j < W; ++j) id[j] += 1;
+            batch_t x{batch_t::gather(t, id)};
+            for (size_t j = 0; j < W; ++j) id[j] += 4;
+            batch_t h{batch_t::gather(t, id) - x};
+
+            batch_t s{batch_t::sqrt(batch_t::max(b * b - four * a * c, zero))};
+            batch_t d{b + s}, flat{batch_t::selectGreaterEqual(c, zero, zero, h)};
+            batch_t u{batch_t::selectGreaterEqual(zero, d, flat, zero - two * c / d)};
+            batch_t r{x + batch_t::min(batch_t::max(u, zero), h)};
+
+            if (m < W)
+            {
+                r.store(out_buffer);
+                std::copy(out_buffer, out_buffer + m, out + i);
+            }
+            else
+                r.store(out + i);
         }
     }
 
+    /**
+     * @brief   Creates an immutable snapshot of the current polynoms, which may be evaluated from
+     *          other threads while this spline is changed, see @ref SplinePublisher.
+     */
+    std::shared_ptr<const CompiledSpline<value_t>> compile()
+    {
+        update();
+        return std::make_shared<const CompiledSpline<value_t>>(
+            this->_knot_x.data(), this->_polynom.data(), this->_knot_x.size(), _uniform,
+            this->_delta);
+    }
+
+    /**
+     * @brief   Creates the arc length table of the current polynoms, see @ref ArcLengthTable.
+     */
+    ArcLengthTable<value_t> arcLengthTable()
+    {
+        update();
+        ArcLengthTable<value_t> table;
+        table.build(this->_knot_x.data(), this->_polynom.data(), this->_knot_x.size());
+        return table;
+    }
+
+    value_t derivative(value_t value)
+    {
+        update();
+        return evaluateDerivative(value);
+    }
+
+    /**
+     * @brief   Hinted version of derivative(value_t), see compute(value_t, size_t &).
+     */
+    value_t derivative(value_t value, size_t & hint)
+    {
+        update();
+        return polynomial_derivative(segment(value, hint), value);
+    }
+
+    /**
+     * @brief   Batched version of derivative(value_t), see compute(const value_t *, value_t *,
+     *          size_t).
+     */
+    void derivative(const value_t * xs, value_t * out, size_t n)
+    {
+        update();
+        evaluateBatch<true>(xs, out, n);
+    }
+
     std::shared_ptr<Spline<value_t>> copy() override
     {
         return std::make_shared<QuadraticSpline<value_t>>(*this);
@@ -0,0 +1,301 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#define MY_MATH_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MY_MATH_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace My::Math
+{
+
+/**
+ * @brief   Thin wrapper around a SIMD register holding width values of value_t.
+ *
+ * The generic template is the scalar fallback (width 1) and works for any value_t. float and
+ * double are specialized for AVX2 (8/4 lanes) or SSE2 (4/2 lanes) depending on the target.
+ * All loads and stores are unaligned.
+ *
+ * @tparam  value_t     The floating point type to operate on.
+ *
+ * @ingroup Math
+ * @author  Ronja Schnur (rschnur@students.uni-mainz.de)
+ */
+template <typename value_t> class Batch
+{
+    // Data
+public:
+    static constexpr size_t width = 1;
+
+    value_t _v;
+
+    // Methods
+public:
+    static Batch load(const value_t * p) { return Batch{p[0]}; }
+
+    static Batch broadcast(value_t v) { return Batch{v}; }
+
+    static Batch min(Batch a, Batch b) { return Batch{std::min(a._v, b._v)}; }
+
+    static Batch max(Batch a, Batch b) { return Batch{std::max(a._v, b._v)}; }
+
+    static Batch sqrt(Batch a)
+    {
+        using std::sqrt;
+        return Batch{sqrt(a._v)};
+    }
+
+    /**
+     * @brief   Rounds towards zero.
+     */
+    static Batch truncate(Batch a)
+    {
+        using std::trunc;
+        return Batch{trunc(a._v)};
+    }
+
+    /**
+     * @brief   Loads base[idx[i]] into lane i.
+     */
+    static Batch gather(const value_t * base, const int32_t * idx) { return Batch{base[idx[0]]}; }
+
+    /**
+     * @brief   Lane-wise a >= b ? t : f.
+     */
+    static Batch selectGreaterEqual(Batch a, Batch b, Batch t, Batch f)
+    {
+        return a._v >= b._v ? t : f;
+    }
+
+    /**
+     * @brief   Writes min(max(int(t), 0), limit) * stride for each lane to out.
+     */
+    static void indices(Batch t, int32_t limit, int32_t stride, int32_t * out)
+    {
+        value_t c = std::min(std::max(t._v, value_t(0)), value_t(limit));
+        out[0] = int32_t(c) * stride;
+    }
+
+    void store(value_t * p) const { p[0] = _v; }
+
+    friend Batch operator+(Batch a, Batch b) { return Batch{a._v + b._v}; }
+    friend Batch operator-(Batch a, Batch b) { return Batch{a._v - b._v}; }
+    friend Batch operator*(Batch a, Batch b) { return Batch{a._v * b._v}; }
+    friend Batch operator/(Batch a, Batch b) { return Batch{a._v / b._v}; }
+};
+
+#if defined(MY_MATH_AVX2)
+
+template <> class Batch<float>
+{
+public:
+    static constexpr size_t width = 8;
+
+    __m256 _v;
+
+public:
+    static Batch load(const float * p) { return Batch{_mm256_loadu_ps(p)}; }
+
+    static Batch broadcast(float v) { return Batch{_mm256_set1_ps(v)}; }
+
+    static Batch min(Batch a, Batch b) { return Batch{_mm256_min_ps(a._v, b._v)}; }
+
+    static Batch max(Batch a, Batch b) { return Batch{_mm256_max_ps(a._v, b._v)}; }
+
+    static Batch sqrt(Batch a) { return Batch{_mm256_sqrt_ps(a._v)}; }
+
+    static Batch truncate(Batch a)
+    {
+        return Batch{_mm256_round_ps(a._v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC)};
+    }
+
+    static Batch gather(const float * base, const int32_t * idx)
+    {
+        __m256i i = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(idx));
+        // masked form: the unmasked one reads an uninitialized source (-Wmaybe-uninitialized)
+        __m256 all{_mm256_castsi256_ps(_mm256_set1_epi32(-1))};
+        return Batch{_mm256_mask_i32gather_ps(_mm256_setzero_ps(), base, i, all, 4)};
+    }
+
+    static Batch selectGreaterEqual(Batch a, Batch b, Batch t, Batch f)
+    {
+        return Batch{_mm256_blendv_ps(f._v, t._v, _mm256_cmp_ps(a._v, b._v, _CMP_GE_OQ))};
+    }
+
+    static void indices(Batch t, int32_t limit, int32_t stride, int32_t * out)
+    {
+        __m256 c = _mm256_min_ps(_mm256_max_ps(t._v, _mm256_setzero_ps()),
+                                 _mm256_set1_ps(float(limit)));
+        __m256i i = _mm256_mullo_epi32(_mm256_cvttps_epi32(c), _mm256_set1_epi32(stride));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), i);
+    }
+
+    void store(float * p) const { _mm256_storeu_ps(p, _v); }
+
+    friend Batch operator+(Batch a, Batch b) { return Batch{_mm256_add_ps(a._v, b._v)}; }
+    friend Batch operator-(Batch a, Batch b) { return Batch{_mm256_sub_ps(a._v, b._v)}; }
+    friend Batch operator*(Batch a, Batch b) { return Batch{_mm256_mul_ps(a._v, b._v)}; }
+    friend Batch operator/(Batch a, Batch b) { return Batch{_mm256_div_ps(a._v, b._v)}; }
+};
+
+template <> class Batch<double>
+{
+public:
+    static constexpr size_t width = 4;
+
+    __m256d _v;
+
+public:
+    static Batch load(const double * p) { return Batch{_mm256_loadu_pd(p)}; }
+
+    static Batch broadcast(double v) { return Batch{_mm256_set1_pd(v)}; }
+
+    static Batch min(Batch a, Batch b) { return Batch{_mm256_min_pd(a._v, b._v)}; }
+
+    static Batch max(Batch a, Batch b) { return Batch{_mm256_max_pd(a._v, b._v)}; }
+
+    static Batch sqrt(Batch a) { return Batch{_mm256_sqrt_pd(a._v)}; }
+
+    static Batch truncate(Batch a)
+    {
+        return Batch{_mm256_round_pd(a._v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC)};
+    }
+
+    static Batch gather(const double * base, const int32_t * idx)
+    {
+        __m128i i = _mm_loadu_si128(reinterpret_cast<const __m128i *>(idx));
+        __m256d all{_mm256_castsi256_pd(_mm256_set1_epi64x(-1))};
+        return Batch{_mm256_mask_i32gather_pd(_mm256_setzero_pd(), base, i, all, 8)};
+    }
+
+    static Batch selectGreaterEqual(Batch a, Batch b, Batch t, Batch f)
+    {
+        return Batch{_mm256_blendv_pd(f._v, t._v, _mm256_cmp_pd(a._v, b._v, _CMP_GE_OQ))};
+    }
+
+    static void indices(Batch t, int32_t limit, int32_t stride, int32_t * out)
+    {
+        __m256d c = _mm256_min_pd(_mm256_max_pd(t._v, _mm256_setzero_pd()),
+                                  _mm256_set1_pd(double(limit)));
+        __m128i i = _mm_mullo_epi32(_mm256_cvttpd_epi32(c), _mm_set1_epi32(stride));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), i);
+    }
+
+    void store(double * p) const { _mm256_storeu_pd(p, _v); }
+
+    friend Batch operator+(Batch a, Batch b) { return Batch{_mm256_add_pd(a._v, b._v)}; }
+    friend Batch operator-(Batch a, Batch b) { return Batch{_mm256_sub_pd(a._v, b._v)}; }
+    friend Batch operator*(Batch a, Batch b) { return Batch{_mm256_mul_pd(a._v, b._v)}; }
+    friend Batch operator/(Batch a, Batch b) { return Batch{_mm256_div_pd(a._v, b._v)}; }
+};
+
+#elif defined(MY_MATH_SSE2)
+
+template <> class Batch<float>
+{
+public:
+    static constexpr size_t width = 4;
+
+    __m128 _v;
+
+public:
+    static Batch load(const float * p) { return Batch{_mm_loadu_ps(p)}; }
+
+    static Batch broadcast(float v) { return Batch{_mm_set1_ps(v)}; }
+
+    static Batch min(Batch a, Batch b) { return Batch{_mm_min_ps(a._v, b._v)}; }
+
+    static Batch max(Batch a, Batch b) { return Batch{_mm_max_ps(a._v, b._v)}; }
+
+    static Batch sqrt(Batch a) { return Batch{_mm_sqrt_ps(a._v)}; }
+
+    static Batch truncate(Batch a) // only valid for |a| < 2^31
+    {
+        return Batch{_mm_cvtepi32_ps(_mm_cvttps_epi32(a._v))};
+    }
+
+    static Batch gather(const float * base, const int32_t * idx)
+    {
+        return Batch{_mm_setr_ps(base[idx[0]], base[idx[1]], base[idx[2]], base[idx[3]])};
+    }
+
+    static Batch selectGreaterEqual(Batch a, Batch b, Batch t, Batch f)
+    {
+        __m128 m = _mm_cmpge_ps(a._v, b._v);
+        return Batch{_mm_or_ps(_mm_and_ps(m, t._v), _mm_andnot_ps(m, f._v))};
+    }
+
+    static void indices(Batch t, int32_t limit, int32_t stride, int32_t * out)
+    {
+        __m128 c = _mm_min_ps(_mm_max_ps(t._v, _mm_setzero_ps()), _mm_set1_ps(float(limit)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_cvttps_epi32(c));
+        for (size_t i = 0; i < width; ++i) out[i] *= stride; // no 32 bit mullo before SSE4.1
+    }
+
+    void store(float * p) const { _mm_storeu_ps(p, _v); }
+
+    friend Batch operator+(Batch a, Batch b) { return Batch{_mm_add_ps(a._v, b._v)}; }
+    friend Batch operator-(Batch a, Batch b) { return Batch{_mm_sub_ps(a._v, b._v)}; }
+    friend Batch operator*(Batch a, Batch b) { return Batch{_mm_mul_ps(a._v, b._v)}; }
+    friend Batch operator/(Batch a, Batch b) { return Batch{_mm_div_ps(a._v, b._v)}; }
+};
+
+template <> class Batch<double>
+{
+public:
+    static constexpr size_t width = 2;
+
+    __m128d _v;
+
+public:
+    static Batch load(const double * p) { return Batch{_mm_loadu_pd(p)}; }
+
+    static Batch broadcast(double v) { return Batch{_mm_set1_pd(v)}; }
+
+    static Batch min(Batch a, Batch b) { return Batch{_mm_min_pd(a._v, b._v)}; }
+
+    static Batch max(Batch a, Batch b) { return Batch{_mm_max_pd(a._v, b._v)}; }
+
+    static Batch sqrt(Batch a) { return Batch{_mm_sqrt_pd(a._v)}; }
+
+    static Batch truncate(Batch a) // only valid for |a| < 2^31
+    {
+        return Batch{_mm_cvtepi32_pd(_mm_cvttpd_epi32(a._v))};
+    }
+
+    static Batch gather(const double * base, const int32_t * idx)
+    {
+        return Batch{_mm_setr_pd(base[idx[0]], base[idx[1]])};
+    }
+
+    static Batch selectGreaterEqual(Batch a, Batch b, Batch t, Batch f)
+    {
+        __m128d m = _mm_cmpge_pd(a._v, b._v);
+        return Batch{_mm_or_pd(_mm_and_pd(m, t._v), _mm_andnot_pd(m, f._v))};
+    }
+
+    static void indices(Batch t, int32_t limit, int32_t stride, int32_t * out)
+    {
+        __m128d c = _mm_min_pd(_mm_max_pd(t._v, _mm_setzero_pd()), _mm_set1_pd(double(limit)));
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(out), _mm_cvttpd_epi32(c));
+        for (size_t i = 0; i < width; ++i) out[i] *= stride;
+    }
+
+    void store(double * p) const { _mm_storeu_pd(p, _v); }
+
+    friend Batch operator+(Batch a, Batch b) { return Batch{_mm_add_pd(a._v, b._v)}; }
+    friend Batch operator-(Batch a, Batch b) { return Batch{_mm_sub_pd(a._v, b._v)}; }
+    friend Batch operator*(Batch a, Batch b) { return Batch{_mm_mul_pd(a._v, b._v)}; }
+    friend Batch operator/(Batch a, Batch b) { return Batch{_mm_div_pd(a._v, b._v)}; }
+};
+
+#endif
+
+} // namespace My::Math
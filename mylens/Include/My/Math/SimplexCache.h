@@ -0,0 +1,316 @@
+#pragma once
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Math/FlatSimplexSolver.h"
+#include "Math/SimplexFunction.h"
+#include "Math/SimplexFunctionArgument.h"
+
+namespace My::Math
+{
+
+/**
+ * @brief   Bounded memo of function values keyed on the coordinates of the argument, quantized
+ *          to multiples of quantum (x_i -> round(x_i / quantum)). Points in the same cell share
+ *          one value, so quantum should be well below the resolution the solver works at.
+ *
+ * The table is allocated on first use (with the dimension of that argument) and never grows: it
+ * has capacity slots rounded up to a power of two, a key probes ways consecutive slots and evicts
+ * the least recently used of them when all are taken. Arguments with coordinates that are not
+ * finite or out of the range of int64_t after quantization are never cached. All functions may
+ * be called concurrently.
+ *
+ * @tparam  value_t     The floating point type to operate on.
+ *
+ * @ingroup Math
+ * @author  Ronja Schnur (rschnur@students.uni-mainz.de)
+ */
+template <typename value_t> class SimplexCache
+{
+    // Data
+public:
+    static constexpr size_t ways = 4;
+
+private:
+    size_t _capacity, _n{0};
+    value_t _quantum;
+
+    std::vector<int64_t> _keys;    // slots x N quantized coordinates
+    std::vector<uint64_t> _hashes; // per slot, 0 = empty
+    std::vector<uint64_t> _stamps; // per slot, time of the last use
+    std::vector<value_t> _values;  // per slot
+    uint64_t _clock{0};
+    std::mutex _mutex;
+
+    std::atomic<size_t> _hits{0}, _misses{0};
+
+    // Constructors
+public:
+    /**
+     * @brief   Create an empty cache.
+     *
+     * @param   capacity    The minimum number of values it can hold.
+     * @param   quantum     The edge length of the cells of one key.
+     */
+    SimplexCache(size_t capacity, value_t quantum) : _capacity{ways}, _quantum{quantum}
+    {
+        while (_capacity < capacity) _capacity *= 2;
+    }
+
+    // Properties
+public:
+    size_t capacity() const noexcept { return _capacity; }
+
+    value_t quantum() const noexcept { return _quantum; }
+
+    size_t hits() const noexcept { return _hits.load(std::memory_order_relaxed); }
+
+    size_t misses() const noexcept { return _misses.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief   hits / (hits + misses), 0 before the first lookup.
+     */
+    double hitRate() const noexcept
+    {
+        size_t h{hits()}, total{h + misses()};
+        return total ? double(h) / double(total) : 0.0;
+    }
+
+    // Methods
+private:
+    void allocate(size_t n) // requires _mutex
+    {
+        if (n == _n) return;
+        _n = n;
+        _keys.assign(_capacity * n, 0);
+        _hashes.assign(_capacity, 0);
+        _stamps.assign(_capacity, 0);
+        _values.assign(_capacity, value_t(0));
+    }
+
+    bool matches(size_t slot, const int64_t * key, uint64_t hash) const
+    {
+        return _hashes[slot] == hash && std::equal(key, key + _n, _keys.begin() + slot * _n);
+    }
+
+public:
+    /**
+     * @brief   Quantizes the n coordinates get(i) into key, the key of lookup() and insert().
+     *
+     * @param   n       The number of coordinates.
+     * @param   get     Callable returning coordinate i.
+     * @param   key     Pointer to n results.
+     *
+     * @return  The hash of the key, 0 if the argument can not be cached.
+     */
+    template <typename get_t> uint64_t quantize(size_t n, get_t && get, int64_t * key) const
+    {
+        constexpr value_t limit{value_t(uint64_t(1) << 62)};
+        uint64_t h{0xcbf29ce484222325ull};
+        for (size_t i = 0; i < n; ++i)
+        {
+            value_t q{value_t(get(i)) / _quantum};
+            if (!(std::abs(q) < limit)) return 0; // also NaN
+            key[i] = int64_t(std::llround(q));
+
+            h ^= uint64_t(key[i]);
+            h *= 0x100000001b3ull;
+        }
+        h ^= h >> 33; // finalizer of MurmurHash3
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        return h | 1;
+    }
+
+    /**
+     * @brief   Looks up the value of a key of n coordinates with hash, see quantize().
+     *
+     * @return  Whether it was found (then written to value).
+     */
+    bool lookup(const int64_t * key, size_t n, uint64_t hash, value_t & value)
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        allocate(n);
+        if (hash)
+            for (size_t w = 0; w < ways; ++w)
+            {
+                size_t slot{(hash + w) & (_capacity - 1)};
+                if (!matches(slot, key, hash)) continue;
+                _stamps[slot] = ++_clock;
+                value = _values[slot];
+                _hits.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        _misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    /**
+     * @brief   Stores the value of a key of n coordinates with hash, see quantize().
+     */
+    void insert(const int64_t * key, size_t n, uint64_t hash, value_t value)
+    {
+        if (!hash) return;
+        std::lock_guard<std::mutex> lock{_mutex};
+        allocate(n);
+
+        size_t target{hash & (_capacity - 1)};
+        for (size_t w = 0; w < ways; ++w)
+        {
+            size_t slot{(hash + w) & (_capacity - 1)};
+            if (matches(slot, key, hash) || _hashes[slot] == 0)
+            {
+                target = slot;
+                break;
+            }
+            if (_stamps[slot] < _stamps[target]) target = slot;
+        }
+
+        std::copy(key, key + n, _keys.begin() + target * _n);
+        _hashes[target] = hash;
+        _stamps[target] = ++_clock;
+        _values[target] = value;
+    }
+
+    /**
+     * @brief   Removes all values and resets the counters.
+     */
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        std::fill(_hashes.begin(), _hashes.end(), 0);
+        _hits = 0;
+        _misses = 0;
+    }
+};
+
+/**
+ * @brief   @ref SimplexFunction that answers arguments it has already seen from a
+ *          @ref SimplexCache and forwards the others to the wrapped function.
+ *
+ *      auto cached = std::make_shared<CachedSimplexFunction<float>>(function, 4096, 1e-7f);
+ *      SimplexSolver<float> solver(cached, init_state, 0.5f, 1e-6f);
+ *
+ * The preCompute() the solver calls before compute() is deferred, on a miss compute() runs
+ * preCompute() and compute() of the wrapped function, on a hit neither of them. The key is taken
+ * from the coordinates before preCompute(), so a preCompute() that changes them (e.g. projects
+ * the argument) does not move the value to another key.
+ *
+ * As a consequence the argument of the SimplexPair a solver returns may never have been
+ * precomputed (if its value came from the cache); call preCompute() of the wrapped function on
+ * it before using what it would compute.
+ *
+ * @tparam  value_t     The floating point type to operate on.
+ *
+ * @ingroup Math
+ * @author  Ronja Schnur (rschnur@students.uni-mainz.de)
+ */
+template <typename value_t> class CachedSimplexFunction : public SimplexFunction<value_t>
+{
+    // Data
+private:
+    std::shared_ptr<SimplexFunction<value_t>> _function;
+    SimplexCache<value_t> _cache;
+
+    // Constructors
+public:
+    /**
+     * @param   function    The wrapped function.
+     * @param   capacity    The minimum number of values the cache holds.
+     * @param   quantum     The edge length of the cells of one key.
+     */
+    CachedSimplexFunction(std::shared_ptr<SimplexFunction<value_t>> function, size_t capacity,
+                          value_t quantum)
+        : _function{std::move(function)}, _cache{capacity, quantum}
+    {}
+
+    // Properties
+public:
+    SimplexCache<value_t> & cache() noexcept { return _cache; }
+
+    // Methods
+public:
+    value_t compute(const std::shared_ptr<SimplexFunctionArgument<value_t>> & t) override
+    {
+        // per call, a nested cached function would overwrite a shared key before insert()
+        size_t n{t->N()};
+        int64_t small[16];
+        std::vector<int64_t> large(n > 16 ? n : 0);
+        int64_t * key{n > 16 ? large.data() : small};
+        uint64_t hash{_cache.quantize(n, [&](size_t i) { return t->get(i); }, key)};
+
+        value_t value;
+        if (_cache.lookup(key, n, hash, value)) return value;
+
+        auto argument{t};
+        _function->preCompute(argument);
+        value = _function->compute(argument);
+        _cache.insert(key, n, hash, value);
+        return value;
+    }
+
+    void preCompute(std::shared_ptr<SimplexFunctionArgument<value_t>> & /*t*/) override {}
+
+    bool threadSafe() override { return _function->threadSafe(); }
+};
+
+/**
+ * @brief   @ref FlatSimplexFunction that answers points it has already seen from a
+ *          @ref SimplexCache and forwards the others to the wrapped function.
+ *
+ * @tparam  value_t     The floating point type to operate on.
+ *
+ * @ingroup Math
+ * @author  Ronja Schnur (rschnur@students.uni-mainz.de)
+ */
+template <typename value_t> class CachedFlatSimplexFunction : public FlatSimplexFunction<value_t>
+{
+    // Data
+private:
+    std::shared_ptr<FlatSimplexFunction<value_t>> _function;
+    SimplexCache<value_t> _cache;
+
+    // Constructors
+public:
+    /**
+     * @param   function    The wrapped function.
+     * @param   capacity    The minimum number of values the cache holds.
+     * @param   quantum     The edge length of the cells of one key.
+     */
+    CachedFlatSimplexFunction(std::shared_ptr<FlatSimplexFunction<value_t>> function,
+                              size_t capacity, value_t quantum)
+        : _function{std::move(function)}, _cache{capacity, quantum}
+    {}
+
+    // Properties
+public:
+    SimplexCache<value_t> & cache() noexcept { return _cache; }
+
+    // Methods
+public:
+    value_t compute(Span<const value_t> x) override
+    {
+        // per call, see CachedSimplexFunction::compute()
+        size_t n{x.size()};
+        int64_t small[16];
+        std::vector<int64_t> large(n > 16 ? n : 0);
+        int64_t * key{n > 16 ? large.data() : small};
+        uint64_t hash{_cache.quantize(n, [&](size_t i) { return x[i]; }, key)};
+
+        value_t value;
+        if (_cache.lookup(key, n, hash, value)) return value;
+
+        value = _function->compute(x);
+        _cache.insert(key, n, hash, value);
+        return value;
+    }
+
+    bool threadSafe() const override { return _function->threadSafe(); }
+};
+
+} // namespace My::Math
@@ -46,6 +46,13 @@ public:
      * @param   t   The argument.
      */
     virtual void preCompute(std::shared_ptr<SimplexFunctionArgument<value_t>> & t) {}
+
+    /**
+     * @brief   Whether compute() and preCompute() may run concurrently on different arguments.
+     *          The solvers then evaluate the points of initialization and shrink in parallel
+     *          (see @ref ThreadPool). Override to opt in.
+     */
+    virtual bool threadSafe() { return false; }
 };
 
 } // namespace My
\ No newline at end of file
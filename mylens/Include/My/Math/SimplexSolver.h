@@ -5,6 +5,9 @@
 #include <numeric>
 #include <vector>
 
+#include "Math/FlatSimplexSolver.h"
+#include "Math/MultiStartSimplexSolver.h"
+#include "Math/Parallel.h"
 #include "Math/SimplexFunction.h"
 #include "Math/SimplexFunctionArgument.h"
 #include "Math/SimplexPair.h"
@@ -30,6 +33,7 @@ private:
 
     std::shared_ptr<SimplexFunctionArgument<value_t>> _init_state;
     value_t _lambda, _tolerance;
+    bool _sorted{false}; // whether all but the last vertex are in order
 
     // CONSTRUCTOR
 public:
@@ -77,23 +81,52 @@ private:
 
     bool sortSimplex()
     {
-        std::sort(_simplex.begin(), _simplex.end());
+        if (!_sorted)
+        {
+            std::sort(_simplex.begin(), _simplex.end());
+            _sorted = true;
+            return true;
+        }
+
+        // only the worst vertex was replaced, move it to its place
+        auto position = std::upper_bound(
+            _simplex.begin(), _simplex.end() - 1, _simplex.back(),
+            [](const SimplexPair<value_t> & a, const SimplexPair<value_t> & b) {
+                return a._second < b._second;
+            });
+        std::rotate(position, _simplex.end() - 1, _simplex.end());
         return true;
     }
 
+    /**
+     * @brief   Computes _simplex[first] .. _simplex[n - 1], concurrently on threadPool() if the
+     *          function is thread safe. Each value is stored with its argument, so the order of
+     *          evaluation does not matter.
+     */
+    void computeSimplex(size_t first)
+    {
+        auto f = [&](size_t i) {
+            auto & p = _simplex[first + i];
+            _function->preCompute(p._first);
+            p._second = _function->compute(p._first);
+        };
+        if (_function->threadSafe())
+            threadPool().run(_simplex.size() - first, f);
+        else
+            for (size_t i = 0; first + i < _simplex.size(); ++i) f(i);
+    }
+
     void initializeSimplex()
     {
-        auto pair = simplexPair(_init_state->copy()); // generate init state
         for (size_t i = 0; i < _init_state->N() + 1; ++i)
         {
-            auto p = simplexPair(pair); // copy init state
-            if (i > 0)                  // 0 = init_state
-            {
-                p._first->set(i - 1, p._first->get(i - 1) + _lambda);
-                p = simplexPair(p._first); // compute new state
-            }
-            _simplex.push_back(p); // push back state
+            auto t = _init_state->copy(); // copy init state
+            if (i > 0)                    // 0 = init_state
+                t->set(i - 1, t->get(i - 1) + _lambda);
+            _simplex.push_back(SimplexPair<value_t>(t, value_t(0)));
         }
+        computeSimplex(0);
+        _sorted = false;
     }
 
 public:
@@ -168,8 +201,10 @@ public:
 
             // 6th step: Shrink
             for (size_t i = 1; i < _simplex.size(); ++i)
-                _simplex[i] =
-                    simplexPair(x_low._first + (_simplex[i]._first - x_low._first) * value_t(0.5));
+                _simplex[i]._first =
+                    x_low._first + (_simplex[i]._first - x_low._first) * value_t(0.5);
+            computeSimplex(1);
+            _sorted = false;
         }
 
 #ifndef _DEBUG
@@ -181,6 +216,56 @@ public:
 
         return _simplex[0];
     }
+
+    /**
+     * @brief   Searches for a local optimum like solve(), but on the coordinates of the
+     *          argument in a @ref FlatSimplexSolver through a @ref SimplexFunctionAdapter. The
+     *          iterations allocate nothing, as the operations of the argument are replaced by
+     *          the ones of R^N, so only use it for arguments that implement those.
+     *
+     * @param   print   Whether to print output process (default: true)
+     *
+     * @return  The found optimum.
+     */
+    SimplexPair<value_t> solveFlat(bool print = true, int * num_iter = nullptr)
+    {
+        auto adapter{std::make_shared<SimplexFunctionAdapter<value_t>>(_function, _init_state)};
+        auto init_state{SimplexFunctionAdapter<value_t>::coordinates(_init_state)};
+        FlatSimplexSolver<value_t> solver(adapter, init_state, _lambda, _tolerance);
+
+        if (print) std::cout << "> Run Simplex-Optimization (flat) ..." << std::flush;
+        value_t value{solver.solve(num_iter)};
+        if (print) std::cout << " Done with " << solver.iterations() << " iterations.\n";
+
+        return SimplexPair<value_t>(adapter->argument(solver.best()), value);
+    }
+
+    /**
+     * @brief   Searches for the best of several local optima with a
+     *          @ref MultiStartSimplexSolver, on the coordinates of the argument like solveFlat().
+     *
+     * @param   runs        The number of runs, run concurrently if the function is thread safe.
+     * @param   radius      Half the edge length of the box of start points around init_state.
+     * @param   print       Whether to print output process (default: true)
+     * @param   statistics  Optional pointer receiving the statistics of every run.
+     *
+     * @return  The best optimum found.
+     */
+    SimplexPair<value_t> solveMultiStart(size_t runs, value_t radius, bool print = true,
+                                         std::vector<SimplexRun<value_t>> * statistics = nullptr)
+    {
+        auto adapter{std::make_shared<SimplexFunctionAdapter<value_t>>(_function, _init_state)};
+        auto init_state{SimplexFunctionAdapter<value_t>::coordinates(_init_state)};
+        MultiStartSimplexSolver<value_t> solver(adapter, init_state, runs, radius, _lambda,
+                                                _tolerance);
+
+        if (print) std::cout << "> Run " << runs << " Simplex-Optimizations ..." << std::flush;
+        value_t value{solver.solve()};
+        if (print) std::cout << " Done.\n";
+
+        if (statistics) *statistics = solver.statistics();
+        return SimplexPair<value_t>(adapter->argument(solver.best()), value);
+    }
 };
 
 } // namespace My
\ No newline at end of file
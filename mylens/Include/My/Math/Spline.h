@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <sstream>
@@ -8,6 +9,7 @@
 #include "Utility/Utility.h"
 
 #include "Math/Intervall.h"
+#include "Math/SIMD.h"
 
 namespace My::Math
 {
@@ -42,8 +44,8 @@ public:
         : _knot_x(num_knots), _knot_y(num_knots), _intervall{intervall},
           _delta((_intervall._end - _intervall._start) / (num_knots - 1))
     {
-        for (value_t i = 0; i < num_knots; ++i)
-            _knot_x[i] = _intervall._start + i * _delta; // equally distributed x-values
+        for (size_t i = 0; i < num_knots; ++i)
+            _knot_x[i] = _intervall._start + value_t(i) * _delta; // equally distributed x-values
     }
 
     /**
@@ -145,6 +147,100 @@ public:
      * @brief   Must return a copy of the derived spline.
      */
     virtual std::shared_ptr<Spline<value_t>> copy() = 0;
+
+    /**
+     * @brief   Sets the y-knots to alpha * t + beta * o without any temporary spline.
+     *
+     * @param   alpha   Factor of the first spline.
+     * @param   t       First spline.
+     * @param   beta    Factor of the second spline.
+     * @param   o       Second spline.
+     *
+     * @return *this
+     */
+    Spline<value_t> & assign(value_t alpha, const Spline<value_t> & t, value_t beta,
+                             const Spline<value_t> & o)
+    {
+        const batch_t a{batch_t::broadcast(alpha)}, b{batch_t::broadcast(beta)};
+        return transform(t._knot_y.data(), o._knot_y.data(),
+                         [&](batch_t x, batch_t y) { return a * x + b * y; });
+    }
+
+    // Operators
+public:
+    /**
+     * @brief   Pairwise in-place addition of the y-knots.
+     */
+    Spline<value_t> & operator+=(const Spline<value_t> & o)
+    {
+        return transform(_knot_y.data(), o._knot_y.data(),
+                         [](batch_t x, batch_t y) { return x + y; });
+    }
+
+    /**
+     * @brief   Pairwise in-place substraction of the y-knots.
+     */
+    Spline<value_t> & operator-=(const Spline<value_t> & o)
+    {
+        return transform(_knot_y.data(), o._knot_y.data(),
+                         [](batch_t x, batch_t y) { return x - y; });
+    }
+
+    /**
+     * @brief   In-place multiplication of the y-knots.
+     */
+    Spline<value_t> & operator*=(value_t o)
+    {
+        const batch_t f{batch_t::broadcast(o)};
+        return transform(_knot_y.data(), _knot_y.data(), [&](batch_t x, batch_t) { return x * f; });
+    }
+
+    /**
+     * @brief   In-place division of the y-knots.
+     */
+    Spline<value_t> & operator/=(value_t o)
+    {
+        const batch_t f{batch_t::broadcast(o)};
+        return transform(_knot_y.data(), _knot_y.data(), [&](batch_t x, batch_t) { return x / f; });
+    }
+
+    // Methods
+protected:
+    using batch_t = Batch<value_t>;
+
+    /**
+     * @brief   Called after the y-knots from knot on were written directly (by the arithmetic
+     *          operators). Override if the spline caches anything derived from them.
+     *
+     * @param   knot    The first changed knot.
+     */
+    virtual void invalidate(size_t /*knot*/) {}
+
+private:
+    /**
+     * @brief   Writes op(a[i], b[i]) to the y-knots, one SIMD register at a time.
+     */
+    template <typename op_t>
+    Spline<value_t> & transform(const value_t * a, const value_t * b, op_t op)
+    {
+        constexpr size_t W = batch_t::width;
+        size_t n{_knot_y.size()}, i{0};
+        value_t * y{_knot_y.data()};
+
+        for (; i + W <= n; i += W) op(batch_t::load(a + i), batch_t::load(b + i)).store(y + i);
+
+        if (i < n) // pad the remainder
+        {
+            value_t a_buffer[W]{}, b_buffer[W]{}, y_buffer[W];
+            std::copy(a + i, a + n, a_buffer);
+            std::copy(b + i, b + n, b_buffer);
+            op(batch_t::load(a_buffer), batch_t::load(b_buffer)).store(y_buffer);
+            std::copy(y_buffer, y_buffer + (n - i), y + i);
+        }
+
+        invalidate(0);
+        return *this;
+    }
 };
 
 /**
@@ -160,7 +256,7 @@ const std::shared_ptr<Spline<value_t>> operator+(std::shared_ptr<Spline<value_t>
                                                  std::shared_ptr<Spline<value_t>> o)
 {
     auto s = t->copy();
-    for (size_t i = 0; i < s->numKnots(); ++i) s->specify(i, t->knotYData()[i] + o->knotYData()[i]);
+    *s += *o;
     return s;
 }
 
@@ -177,7 +273,7 @@ const std::shared_ptr<Spline<value_t>> operator-(std::shared_ptr<Spline<value_t>
                                                  std::shared_ptr<Spline<value_t>> o)
 {
     auto s = t->copy();
-    for (size_t i = 0; i < s->numKnots(); ++i) s->specify(i, t->knotYData()[i] - o->knotYData()[i]);
+    *s -= *o;
     return s;
 }
 
@@ -193,7 +289,7 @@ template <typename value_t>
 const std::shared_ptr<Spline<value_t>> operator/(std::shared_ptr<Spline<value_t>> t, value_t o)
 {
     auto s = t->copy();
-    for (size_t i = 0; i < s->numKnots(); ++i) s->specify(i, t->knotYData()[i] / o);
+    *s /= o;
     return s;
 }
 
@@ -209,10 +305,74 @@ template <typename value_t>
 const std::shared_ptr<Spline<value_t>> operator*(std::shared_ptr<Spline<value_t>> t, value_t o)
 {
     auto s = t->copy();
-    for (size_t i = 0; i < s->numKnots(); ++i) s->specify(i, t->knotYData()[i] * o);
+    *s *= o;
     return s;
 }
 
+/**
+ * @brief   In-place pairwise addition of y-KnotData, allocates nothing.
+ *
+ * @param   t   First spline, receives the result.
+ * @param   o   Second spline.
+ *
+ * @return t
+ */
+template <typename value_t>
+const std::shared_ptr<Spline<value_t>> & operator+=(const std::shared_ptr<Spline<value_t>> & t,
+                                                    const std::shared_ptr<Spline<value_t>> & o)
+{
+    *t += *o;
+    return t;
+}
+
+/**
+ * @brief   In-place pairwise substraction of y-KnotData, allocates nothing.
+ *
+ * @param   t   First spline, receives the result.
+ * @param   o   Second spline.
+ *
+ * @return t
+ */
+template <typename value_t>
+const std::shared_ptr<Spline<value_t>> & operator-=(const std::shared_ptr<Spline<value_t>> & t,
+                                                    const std::shared_ptr<Spline<value_t>> & o)
+{
+    *t -= *o;
+    return t;
+}
+
+/**
+ * @brief   In-place division of y-KnotData, allocates nothing.
+ *
+ * @param   t   Spline, receives the result.
+ * @param   o   value
+ *
+ * @return t
+ */
+template <typename value_t>
+const std::shared_ptr<Spline<value_t>> & operator/=(const std::shared_ptr<Spline<value_t>> & t,
+                                                    value_t o)
+{
+    *t /= o;
+    return t;
+}
+
+/**
+ * @brief   In-place multiplication of y-KnotData, allocates nothing.
+ *
+ * @param   t   Spline, receives the result.
+ * @param   o   value
+ *
+ * @return t
+ */
+template <typename value_t>
+const std::shared_ptr<Spline<value_t>> & operator*=(const std::shared_ptr<Spline<value_t>> & t,
+                                                    value_t o)
+{
+    *t *= o;
+    return t;
+}
+
 /**
  * @brief   Operator which enables printing argument to std::ostream.
  *
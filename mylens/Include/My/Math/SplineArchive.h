@@ -0,0 +1,342 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Math/CubicSpline.h"
+#include "Math/Intervall.h"
+#include "Math/QuadraticSpline.h"
+
+namespace My::Math
+{
+
+/**
+ * @brief   Binary layout of a spline archive (version 1), in native byte order:
+ *
+ *      SplineArchiveHeader
+ *      uint64_t offset[count]                  // of each record from the start of the archive
+ *      record[count], each 16 byte aligned:
+ *          SplineRecordHeader
+ *          value_t start, end, delta, 0        // the Intervall and the knot distance
+ *          value_t knot_x[num_knots], knot_y[num_knots]
+ *          value_t polynom[(num_knots - 1) * coefficients]
+ *
+ * The quadratic polynoms are stored as generated (a x^2 + b x + c), the cubic ones relative to
+ * their left knot (see @ref CubicSpline).
+ *
+ * @ingroup Math
+ */
+struct SplineArchiveHeader
+{
+    static constexpr uint32_t magic_value = 0x4153594D; // "MYSA"
+    static constexpr uint32_t order_value = 0x01020304; // detects foreign byte order
+    static constexpr uint32_t current_version = 1;
+
+    uint32_t magic{magic_value};
+    uint32_t order{order_value};
+    uint32_t version{current_version};
+    uint32_t value_size{0}; // sizeof(value_t)
+    uint64_t count{0};      // number of splines
+};
+
+/**
+ * @brief   Header of one spline in a spline archive, see @ref SplineArchiveHeader.
+ *
+ * @ingroup Math
+ */
+struct SplineRecordHeader
+{
+    enum Type : uint32_t
+    {
+        Quadratic = 1,
+        Cubic = 2
+    };
+
+    uint32_t type{Quadratic};
+    uint32_t uniform{0};
+    uint64_t num_knots{0};
+
+    size_t coefficients() const noexcept { return type == Cubic ? 4 : 3; }
+};
+
+/**
+ * @brief   Read-only spline evaluated in place on the memory of a spline archive (for example a
+ *          memory mapped file, see Utility::MappedFile). It does not own the memory.
+ *
+ * Evaluation matches compute() of the spline it was written from.
+ *
+ * @tparam  value_t     The floating point type to operate on.
+ *
+ * @ingroup Math
+ * @author  Ronja Schnur (rschnur@students.uni-mainz.de)
+ */
+template <typename value_t> class SplineView
+{
+    // Data
+private:
+    const SplineRecordHeader * _header{nullptr};
+    const value_t *_intervall{nullptr}, *_knot_x{nullptr}, *_knot_y{nullptr}, *_polynom{nullptr};
+    size_t _n{0};
+
+    // Constructors
+public:
+    SplineView() = default;
+
+    /**
+     * @brief   Create new instance on a record, see @ref SplineArchive.
+     */
+    explicit SplineView(const void * record)
+        : _header{static_cast<const SplineRecordHeader *>(record)}, _n{size_t(_header->num_knots)}
+    {
+        _intervall = reinterpret_cast<const value_t *>(_header + 1);
+        _knot_x = _intervall + 4;
+        _knot_y = _knot_x + _n;
+        _polynom = _knot_y + _n;
+    }
+
+    // Properties
+public:
+    SplineRecordHeader::Type type() const noexcept
+    {
+        return SplineRecordHeader::Type(_header->type);
+    }
+
+    bool uniform() const noexcept { return _header->uniform != 0; }
+
+    Intervall<value_t> intervall() const noexcept { return {_intervall[0], _intervall[1]}; }
+
+    size_t numKnots() const noexcept { return _n; }
+
+    const value_t * knotXData() const noexcept { return _knot_x; }
+
+    const value_t * knotYData() const noexcept { return _knot_y; }
+
+    const value_t * polynomData() const noexcept { return _polynom; }
+
+    // Methods
+private:
+    size_t segment(value_t value) const
+    {
+        if (!(value > _knot_x[0])) return 0;
+        if (uniform()) return std::min(size_t((value - _knot_x[0]) / _intervall[2]), _n - 1);
+        return size_t(std::upper_bound(_knot_x, _knot_x + _n, value) - _knot_x) - 1;
+    }
+
+public:
+    value_t compute(value_t value) const
+    {
+        size_t i{segment(value)};
+        if (i == _n - 1) // constant behind the intervall
+        {
+            i = _n - 2;
+            value = _knot_x[_n - 1];
+        }
+
+        if (_header->type == SplineRecordHeader::Cubic)
+        {
+            const value_t * p{_polynom + 4 * i};
+            value_t t{value - _knot_x[i]};
+            return ((p[0] * t + p[1]) * t + p[2]) * t + p[3];
+        }
+        const value_t * p{_polynom + 3 * i};
+        return p[0] * value * value + p[1] * value + p[2];
+    }
+
+    value_t operator()(value_t value) const { return compute(value); }
+
+    value_t derivative(value_t value) const
+    {
+        size_t i{std::min(segment(value), _n - 2)};
+        if (_header->type == SplineRecordHeader::Cubic)
+        {
+            const value_t * p{_polynom + 4 * i};
+            value_t t{value - _knot_x[i]};
+            return (3 * p[0] * t + 2 * p[1]) * t + p[2];
+        }
+        return 2 * _polynom[3 * i] * value + _polynom[3 * i + 1];
+    }
+};
+
+/**
+ * @brief   Zero-copy reader of a spline archive. It validates the layout once and hands out
+ *          @ref SplineView "SplineViews" on the records, no std::vector is built.
+ *
+ *      Utility::MappedFile file{"splines.bin"};
+ *      SplineArchive<float> archive(file.data(), file.size());
+ *      float y = archive[42](0.5f);
+ *
+ * @tparam  value_t     The floating point type to operate on.
+ *
+ * @ingroup Math
+ * @author  Ronja Schnur (rschnur@students.uni-mainz.de)
+ */
+template <typename value_t> class SplineArchive
+{
+    // Data
+private:
+    const char * _data;
+    size_t _count;
+
+    // Constructors
+public:
+    /**
+     * @brief   Create new instance on the memory of an archive, which has to outlive it.
+     *
+     * @throws  std::runtime_error if the memory does not hold a valid archive of value_t.
+     */
+    SplineArchive(const void * data, size_t size) : _data{static_cast<const char *>(data)}
+    {
+        auto fail = []() { throw std::runtime_error("SplineArchive: invalid archive."); };
+
+        const auto * header{reinterpret_cast<const SplineArchiveHeader *>(_data)};
+        if (size < sizeof(SplineArchiveHeader) || header->magic != header->magic_value ||
+            header->order != header->order_value || header->version != header->current_version ||
+            header->value_size != sizeof(value_t))
+            fail();
+
+        _count = size_t(header->count);
+        if ((size - sizeof(SplineArchiveHeader)) / sizeof(uint64_t) < _count) fail();
+
+        for (size_t i = 0; i < _count; ++i)
+        {
+            // subtractions only, offset and n come from the file and may be anything
+            uint64_t offset{offsets()[i]};
+            if (offset % 16 || offset > size || sizeof(SplineRecordHeader) > size - offset) fail();
+
+            const auto * record{reinterpret_cast<const SplineRecordHeader *>(_data + offset)};
+            uint64_t n{record->num_knots};
+            if (n < 2 || n > size ||
+                (record->type != record->Quadratic && record->type != record->Cubic))
+                fail();
+
+            uint64_t values{4 + 2 * n + (n - 1) * record->coefficients()}; // n <= size, no wrap
+            if (values > (size - offset - sizeof(SplineRecordHeader)) / sizeof(value_t)) fail();
+        }
+    }
+
+    // Properties
+public:
+    size_t size() const noexcept { return _count; }
+
+    // Methods
+private:
+    const uint64_t * offsets() const
+    {
+        return reinterpret_cast<const uint64_t *>(_data + sizeof(SplineArchiveHeader));
+    }
+
+public:
+    SplineView<value_t> operator[](size_t i) const
+    {
+        return SplineView<value_t>(_data + offsets()[i]);
+    }
+};
+
+/**
+ * @brief   Collects splines and writes them as a spline archive, see @ref SplineArchiveHeader.
+ *
+ * @tparam  value_t     The floating point type to operate on.
+ *
+ * @ingroup Math
+ * @author  Ronja Schnur (rschnur@students.uni-mainz.de)
+ */
+template <typename value_t> class SplineArchiveWriter
+{
+    // Data
+private:
+    std::vector<char> _records;
+    std::vector<uint64_t> _offsets; // relative to the first record
+
+    // Methods
+private:
+    void add(SplineRecordHeader::Type type, bool uniform, const Spline<value_t> & spline,
+             size_t num_polynom)
+    {
+        SplineRecordHeader header;
+        header.type = type;
+        header.uniform = uniform;
+        header.num_knots = spline.numKnots();
+
+        size_t n{spline.numKnots()};
+        Intervall<value_t> intervall{spline.intervall()};
+        value_t head[4]{intervall._start, intervall._end,
+                        (intervall._end - intervall._start) / value_t(n - 1), 0};
+
+        _offsets.push_back(_records.size());
+        auto append = [this](const void * data, size_t bytes) {
+            const char * c{static_cast<const char *>(data)};
+            _records.insert(_records.end(), c, c + bytes);
+        };
+        append(&header, sizeof(header));
+        append(head, sizeof(head));
+        append(spline.knotXData(), n * sizeof(value_t));
+        append(spline.knotYData(), n * sizeof(value_t));
+        append(spline.polynomData(), num_polynom * sizeof(value_t));
+        _records.resize((_records.size() + 15) / 16 * 16, 0);
+    }
+
+public:
+    size_t size() const noexcept { return _offsets.size(); }
+
+    /**
+     * @brief   Adds spline, generating it if necessary.
+     */
+    void add(QuadraticSpline<value_t> & spline)
+    {
+        spline.update();
+        add(SplineRecordHeader::Quadratic, spline.uniform(), spline, 3 * (spline.numKnots() - 1));
+    }
+
+    /**
+     * @brief   Adds spline, generating it if necessary.
+     */
+    void add(CubicSpline<value_t> & spline)
+    {
+        spline.update();
+        add(SplineRecordHeader::Cubic, spline.uniform(), spline, 4 * (spline.numKnots() - 1));
+    }
+
+    /**
+     * @brief   The archive, readable by @ref SplineArchive.
+     */
+    std::vector<char> data() const
+    {
+        SplineArchiveHeader header;
+        header.value_size = sizeof(value_t);
+        header.count = _offsets.size();
+
+        size_t start{sizeof(header) + _offsets.size() * sizeof(uint64_t)};
+        start = (start + 15) / 16 * 16;
+
+        std::vector<char> data(start + _records.size(), 0);
+        std::memcpy(data.data(), &header, sizeof(header));
+        for (size_t i = 0; i < _offsets.size(); ++i)
+        {
+            uint64_t offset{start + _offsets[i]};
+            std::memcpy(data.data() + sizeof(header) + i * sizeof(uint64_t), &offset,
+                        sizeof(offset));
+        }
+        std::copy(_records.begin(), _records.end(), data.begin() + start);
+        return data;
+    }
+
+    /**
+     * @brief   Writes the archive to a file.
+     *
+     * @throws  std::runtime_error if the file cannot be written.
+     */
+    void save(const std::string & path) const
+    {
+        std::vector<char> d{data()};
+        std::ofstream file(path, std::ios::binary);
+        if (!file.write(d.data(), std::streamsize(d.size())))
+            throw std::runtime_error("SplineArchive: could not write " + path + ".");
+    }
+};
+
+} // namespace My::Math
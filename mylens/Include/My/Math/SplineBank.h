@@ -0,0 +1,303 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "Math/Intervall.h"
+#include "Math/QuadraticSpline.h"
+#include "Math/SIMD.h"
+
+namespace My::Math
+{
+
+/**
+ * @brief   Many quadratic splines with the same knots, stored as structure of arrays.
+ *
+ * All splines share their x-knots, the y-knots and coefficients are stored knot/polynom major,
+ * spline minor (a_0 of all splines, b_0 of all splines, ...). generate() computes the
+ * coefficients of all splines in one pass and compute() evaluates all splines at one x with a
+ * single segment lookup and contiguous SIMD loads across the splines (see @ref Batch).
+ *
+ * The y-knots have the meaning of the kind the bank is created with:
+ *  - Kind::Quadratic:      y-values, like @ref QuadraticSpline.
+ *  - Kind::Gradient:       y_0 followed by gradients, like GradientSpline(num_knots - 1, ...,
+ *                          y_0).
+ *  - Kind::GradientLast:   y_0, gradients, y_n, like GradientSpline(num_knots - 2, ..., y_0,
+ *                          y_n).
+ *
+ * @tparam  value_t     The floating point type to operate on.
+ *
+ * @ingroup Math
+ * @author  Ronja Schnur (rschnur@students.uni-mainz.de)
+ */
+template <typename value_t> class SplineBank
+{
+public:
+    enum class Kind
+    {
+        Quadratic,
+        Gradient,
+        GradientLast
+    };
+
+private:
+    using batch_t = Batch<value_t>;
+    static constexpr size_t W = batch_t::width;
+
+    // Data
+private:
+    size_t _count, _stride; // number of splines, padded to the register width
+    Kind _kind;
+    bool _uniform{true};
+    value_t _delta;
+
+    std::vector<value_t> _knot_x;       // shared by all splines
+    std::vector<value_t> _knot_y;       // [knot][spline]
+    std::vector<value_t> _polynom;      // [polynom][a, b, c][spline]
+    std::vector<value_t> _s0, _s1, _s2; // scratch of generate, one value per spline
+
+    // Constructors
+public:
+    /**
+     * @brief   Create new instance with equally distributed knots.
+     *
+     * @param   count       Number of splines.
+     * @param   num_knots   Number of knots of each spline.
+     * @param   intervall   Intervall in which the splines live.
+     * @param   kind        The construction of the splines.
+     */
+    SplineBank(size_t count, size_t num_knots, Intervall<value_t> intervall,
+               Kind kind = Kind::Gradient)
+        : _count{count}, _stride{(count + W - 1) / W * W}, _kind{kind},
+          _delta{(intervall._end - intervall._start) / value_t(num_knots - 1)},
+          _knot_x(num_knots), _knot_y(num_knots * _stride),
+          _polynom((num_knots - 1) * 3 * _stride), _s0(_stride), _s1(_stride), _s2(_stride)
+    {
+        for (size_t i = 0; i < num_knots; ++i)
+            _knot_x[i] = intervall._start + value_t(i) * _delta;
+    }
+
+    // Properties
+public:
+    size_t size() const noexcept { return _count; }
+
+    size_t numKnots() const noexcept { return _knot_x.size(); }
+
+    Kind kind() const noexcept { return _kind; }
+
+    Intervall<value_t> intervall() const noexcept { return {_knot_x.front(), _knot_x.back()}; }
+
+    const std::vector<value_t> & X() const { return _knot_x; }
+
+    /**
+     * @brief   Specify the y-knot of one spline.
+     *
+     * @param   spline  The ID of the spline.
+     * @param   knot    The ID of the knot.
+     * @param   value   The new y-value.
+     */
+    void specify(size_t spline, size_t knot, value_t value)
+    {
+        _knot_y[knot * _stride + spline] = value;
+    }
+
+    value_t knotY(size_t spline, size_t knot) const { return _knot_y[knot * _stride + spline]; }
+
+    /**
+     * @brief   Copies the y-knots of a spline of the same shape into the bank.
+     *
+     * @param   spline  The ID of the spline within the bank.
+     * @param   s       The spline, must have numKnots() knots.
+     */
+    void specify(size_t spline, const Spline<value_t> & s)
+    {
+        for (size_t k = 0; k < _knot_x.size(); ++k) specify(spline, k, s.knotYData()[k]);
+    }
+
+    /**
+     * @brief   Change a shared x-knot.
+     *
+     * @param   knot    The ID of the knot.
+     * @param   value   The new x-value.
+     */
+    void specifyX(size_t knot, value_t value)
+    {
+        _uniform = false;
+        _knot_x[knot] = value;
+    }
+
+    // Methods
+private:
+    const value_t * y(size_t knot) const { return _knot_y.data() + knot * _stride; }
+
+    value_t width(size_t i) const { return _uniform ? _delta : _knot_x[i] - _knot_x[i - 1]; }
+
+    value_t * polynom(size_t i, size_t coefficient)
+    {
+        return _polynom.data() + (i * 3 + coefficient) * _stride;
+    }
+
+    size_t segment(value_t value) const
+    {
+        const auto & x{_knot_x};
+        if (!(value > x[0])) return 0;
+        if (_uniform) return std::min(size_t((value - x[0]) / _delta), x.size() - 1);
+        return size_t(std::upper_bound(x.begin(), x.end(), value) - x.begin()) - 1;
+    }
+
+    void generateQuadratic()
+    {
+        // QuadraticSpline::generateFrom, with _s0 = w[i - 2], _s1 = w[i - 1], _s2 = d[i - 1]
+        std::fill(_s0.begin(), _s0.end(), value_t(0));
+        std::fill(_s1.begin(), _s1.end(), value_t(0));
+        std::fill(_s2.begin(), _s2.end(), value_t(0));
+
+        const batch_t two{batch_t::broadcast(2)}, half{batch_t::broadcast(value_t(0.5))};
+        const batch_t zero{batch_t::broadcast(0)};
+        for (size_t i = 1; i < _knot_x.size(); ++i)
+        {
+            const value_t x_0{_knot_x[i - 1]};
+            const batch_t h{batch_t::broadcast(_knot_x[i] - x_0)}; // as QuadraticSpline
+            const batch_t x{batch_t::broadcast(x_0)};
+            value_t *a{polynom(i - 1, 0)}, *b{polynom(i - 1, 1)}, *c{polynom(i - 1, 2)};
+
+            for (size_t s = 0; s < _stride; s += W)
+            {
+                batch_t y_0{batch_t::load(y(i - 1) + s)}, y_1{batch_t::load(y(i) + s)};
+                batch_t w_2{batch_t::load(_s0.data() + s)}, w_1{batch_t::load(_s1.data() + s)};
+
+                batch_t d{two * (y_1 - y_0) / h};
+                batch_t w{d - batch_t::load(_s2.data() + s) + (i > 1 ? w_2 : zero)};
+
+                batch_t p_a{half * (w - w_1) / h};
+                p_a.store(a + s);
+                (w_1 - two * p_a * x).store(b + s);
+                (p_a * x * x - w_1 * x + y_0).store(c + s);
+
+                w_1.store(_s0.data() + s);
+                w.store(_s1.data() + s);
+                d.store(_s2.data() + s);
+            }
+        }
+    }
+
+    void generateGradient()
+    {
+        // GradientSpline::generateFrom, with _s0 = accumulated value
+        std::copy(y(0), y(0) + _stride, _s0.begin());
+
+        const size_t n{_knot_x.size() - 1};
+        const size_t border{_knot_x.size() - (_kind == Kind::GradientLast ? 2 : 1)};
+        const batch_t two{batch_t::broadcast(2)}, zero{batch_t::broadcast(0)};
+
+        for (size_t i = 1; i < border + 1; ++i)
+        {
+            const value_t x_0{_knot_x[i - 1]};
+            const batch_t delta{batch_t::broadcast(width(i))};
+            const batch_t x{batch_t::broadcast(x_0)};
+            value_t *a{polynom(i - 1, 0)}, *b{polynom(i - 1, 1)}, *c{polynom(i - 1, 2)};
+
+            for (size_t s = 0; s < _stride; s += W)
+            {
+                batch_t eta_0{i > 1 ? batch_t::load(y(i - 1) + s) : zero};
+                batch_t eta_1{batch_t::load(y(i) + s)};
+                batch_t acc{batch_t::load(_s0.data() + s)};
+
+                ((eta_1 - eta_0) / (two * delta)).store(a + s);
+                ((x * (eta_0 - eta_1)) / delta + eta_0).store(b + s);
+                ((x * x * (eta_1 - eta_0)) / (two * delta) - x * eta_0 + acc).store(c + s);
+                ((delta * (eta_0 + eta_1)) / two + acc).store(_s0.data() + s);
+            }
+        }
+
+        if (_kind != Kind::GradientLast) return;
+
+        const value_t x_0{_knot_x[n - 1]};
+        const batch_t delta{batch_t::broadcast(width(n))};
+        const batch_t dd{delta * delta};
+        const batch_t x{batch_t::broadcast(x_0)};
+        value_t *a{polynom(n - 1, 0)}, *b{polynom(n - 1, 1)}, *c{polynom(n - 1, 2)};
+
+        for (size_t s = 0; s < _stride; s += W)
+        {
+            batch_t eta{n > 1 ? batch_t::load(y(n - 1) + s) : zero};
+            batch_t y_n{batch_t::load(y(n) + s)};
+            batch_t acc{batch_t::load(_s0.data() + s)};
+
+            ((zero - acc + y_n - delta * eta) / dd).store(a + s);
+            ((two * x * acc - two * x * y_n + two * delta * x * eta) / dd + eta).store(b + s);
+            ((y_n * x * x + acc * dd - acc * x * x - x * eta * dd - delta * eta * x * x) / dd)
+                .store(c + s);
+        }
+    }
+
+    template <bool derivative_v> void evaluate(value_t value, value_t * out)
+    {
+        size_t i{segment(value)};
+        if (i == _knot_x.size() - 1) // behind the last knot: last polynom at the last knot
+        {
+            if constexpr (!derivative_v) value = _knot_x.back();
+            i--;
+        }
+
+        const value_t *a{polynom(i, 0)}, *b{polynom(i, 1)}, *c{polynom(i, 2)};
+        const batch_t x{batch_t::broadcast(value)}, two{batch_t::broadcast(2)};
+        value_t buffer[W];
+
+        for (size_t s = 0; s < _stride; s += W)
+        {
+            batch_t p_a{batch_t::load(a + s)}, p_b{batch_t::load(b + s)};
+            batch_t r{two * p_a * x + p_b};
+            if constexpr (!derivative_v) r = (p_a * x + p_b) * x + batch_t::load(c + s);
+
+            if (s + W <= _count)
+                r.store(out + s);
+            else
+            {
+                r.store(buffer);
+                std::copy(buffer, buffer + (_count - s), out + s);
+            }
+        }
+    }
+
+public:
+    /**
+     * @brief   Computes the polynom coefficients of all splines.
+     */
+    void generate()
+    {
+        if (_kind == Kind::Quadratic)
+            generateQuadratic();
+        else
+            generateGradient();
+    }
+
+    /**
+     * @brief   Computes all splines at value.
+     *
+     * @param   value   X value to compute.
+     * @param   out     Pointer to size() results.
+     */
+    void compute(value_t value, value_t * out) { evaluate<false>(value, out); }
+
+    /**
+     * @brief   Computes the derivative of all splines at value.
+     *
+     * @param   value   X value to compute.
+     * @param   out     Pointer to size() results.
+     */
+    void derivative(value_t value, value_t * out) { evaluate<true>(value, out); }
+
+    /**
+     * @brief   Computes a single spline at value.
+     */
+    value_t compute(size_t spline, value_t value)
+    {
+        size_t i{segment(value)};
+        if (i == _knot_x.size() - 1) value = _knot_x[i--];
+        return (polynom(i, 0)[spline] * value + polynom(i, 1)[spline]) * value +
+               polynom(i, 2)[spline];
+    }
+};
+
+} // namespace My::Math
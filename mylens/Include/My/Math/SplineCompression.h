@@ -0,0 +1,144 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include "Math/QuadraticSpline.h"
+
+namespace My::Math
+{
+
+/**
+ * @brief   Exact maximum of |a(x) - b(x)| over the intervall of a. Between two consecutive knots
+ *          of either spline the difference is one quadratic, so it is evaluated at the knots and
+ *          at the vertices only. Both splines have to be generated.
+ *
+ * @ingroup Math
+ */
+template <typename value_t>
+value_t maxDeviation(const QuadraticSpline<value_t> & a, const QuadraticSpline<value_t> & b)
+{
+    using std::abs;
+    const auto &ax{a.X()}, &bx{b.X()};
+    std::vector<value_t> x;
+    x.reserve(ax.size() + bx.size());
+    std::merge(ax.begin(), ax.end(), bx.begin(), bx.end(), std::back_inserter(x));
+    x.erase(std::remove_if(x.begin(), x.end(),
+                           [&](value_t v) { return v < ax.front() || v > ax.back(); }),
+            x.end());
+
+    auto error = [&](value_t v) { return value_t(abs(a.evaluate(v) - b.evaluate(v))); };
+    value_t result{0};
+    for (size_t i = 0; i < x.size(); ++i)
+    {
+        result = std::max(result, error(x[i]));
+        if (i == 0 || !(x[i] > x[i - 1])) continue;
+
+        // vertex of the difference between x[i - 1] and x[i], its slope is sampled inside only
+        auto slope = [&](value_t v) { return a.evaluateDerivative(v) - b.evaluateDerivative(v); };
+        value_t h{(x[i] - x[i - 1]) / 2}, m{x[i - 1] + h};
+        value_t curvature{(slope(m + h / 2) - slope(m - h / 2)) / h};
+        if (curvature == 0) continue;
+        value_t v{m - slope(m) / curvature};
+        if (v > x[i - 1] && v < x[i]) result = std::max(result, error(v));
+    }
+    return result;
+}
+
+/**
+ * @brief   Result of compress(): the reduced spline and how well it does.
+ *
+ * @ingroup Math
+ */
+template <typename value_t> struct CompressedSpline
+{
+    std::shared_ptr<QuadraticSpline<value_t>> spline;
+    size_t original_knots{0};
+    value_t error{0}; // maximum deviation from the original, see maxDeviation()
+
+    size_t knots() const noexcept { return spline->numKnots(); }
+
+    /**
+     * @brief   Knots of the original per knot of the reduced spline.
+     */
+    value_t ratio() const noexcept { return value_t(original_knots) / value_t(knots()); }
+};
+
+/**
+ * @brief   Reduces a QuadraticSpline (or subclass, e.g. GradientSpline) to a non-uniform
+ *          QuadraticSpline on a subset of its knots that stays within tolerance of it.
+ *
+ * The polynoms of a QuadraticSpline only depend on the knots in front of them, so the reduced
+ * spline is built from left to right: from the last kept knot (whose slope is known) it jumps to
+ * the farthest following knot for which the new polynom stays within tolerance, checked exactly
+ * against every original polynom it covers, and keeps that one. Each check stops at its first
+ * violation, so a polynom spanning L original ones costs O(L^2) in the worst case.
+ *
+ * Every polynom of a QuadraticSpline starts with slope 0, so if the original does not (as a
+ * GradientSpline may) the first polynoms can exceed tolerance even without removed knots;
+ * error reports the deviation actually reached.
+ *
+ * @param   source      The spline to compress.
+ * @param   tolerance   The maximum absolute deviation from source.
+ *
+ * @ingroup Math
+ */
+template <typename value_t>
+CompressedSpline<value_t> compress(QuadraticSpline<value_t> & source, value_t tolerance)
+{
+    using std::abs;
+    source.update();
+    const value_t *x{source.knotXData()}, *p{source.polynomData()};
+    size_t n{source.numKnots()};
+
+    std::vector<value_t> v(n);
+    for (size_t i = 0; i < n; ++i) v[i] = source.evaluate(x[i]);
+
+    // whether the polynom from knot j (value v[j], slope w) to knot k fits the source
+    auto fits = [&](size_t j, size_t k, value_t w) {
+        value_t h{x[k] - x[j]}, a{(v[k] - v[j] - w * h) / (h * h)};
+        auto error = [&](size_t s, value_t t) { // t = x - x[j] inside source polynom s
+            value_t x_s{x[j] + t};
+            value_t q{(p[3 * s] * x_s + p[3 * s + 1]) * x_s + p[3 * s + 2]};
+            return value_t(abs((a * t + w) * t + v[j] - q));
+        };
+
+        for (size_t s = j; s < k; ++s)
+        {
+            value_t l{x[s] - x[j]}, r{x[s + 1] - x[j]};
+            if (error(s, r) > tolerance) return false;
+
+            // vertex of the difference, (2 a - 2 a_s) t = 2 a_s x[j] + b_s - w
+            value_t curvature{2 * (a - p[3 * s])};
+            if (curvature == 0) continue;
+            value_t t{(2 * p[3 * s] * x[j] + p[3 * s + 1] - w) / curvature};
+            if (t > l && t < r && error(s, t) > tolerance) return false;
+        }
+        return true;
+    };
+
+    std::vector<value_t> kx{x[0]}, ky{v[0]};
+    value_t w{0}; // slope of the reduced spline at the last kept knot
+    for (size_t j = 0; j < n - 1;)
+    {
+        size_t k{j + 1};
+        while (k + 1 < n && fits(j, k + 1, w)) ++k;
+
+        w = 2 * (v[k] - v[j]) / (x[k] - x[j]) - w;
+        kx.push_back(x[k]);
+        ky.push_back(v[k]);
+        j = k;
+    }
+
+    CompressedSpline<value_t> result;
+    result.spline = std::make_shared<QuadraticSpline<value_t>>(std::move(kx), std::move(ky));
+    result.spline->generate();
+    result.original_knots = n;
+    result.error = maxDeviation(*result.spline, source);
+    return result;
+}
+
+} // namespace My::Math
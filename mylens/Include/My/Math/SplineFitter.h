@@ -0,0 +1,341 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "Math/CurvatureSpline.h"
+#include "Math/GradientSpline.h"
+#include "Math/QuadraticSpline.h"
+
+namespace My::Math
+{
+
+/**
+ * @brief   Weighted linear least squares fit of a quadratic spline whose polynoms depend
+ *          affinely on a parameter vector p:
+ *
+ *      f(x) = offset(x) + sum_j p_j basis_j(x)
+ *
+ * Offset and basis are given as polynom coefficients on shared knots. Samples are streamed
+ * through add(), which accumulates the normal equations (G + lambda I) p = h without storing
+ * them; solve() factorizes them with Cholesky. For the spline types of this module the basis
+ * functions reach from their knot to the end of the intervall (the recurrences carry every
+ * knot to the right), so G is dense; each sample only touches the parameters up to its segment.
+ *
+ * Use the fit() functions for QuadraticSpline, GradientSpline and CurvatureSpline, which set up
+ * the basis from the spline itself (one generation per parameter) and write the result back.
+ *
+ * @tparam  value_t     The floating point type to operate on.
+ *
+ * @ingroup Math
+ * @author  Ronja Schnur (rschnur@students.uni-mainz.de)
+ */
+template <typename value_t> class SplineFitter
+{
+    // Data
+private:
+    std::vector<value_t> _knot_x;
+    size_t _params;
+    std::vector<value_t> _offset;  // [polynom][a, b, c]
+    std::vector<value_t> _basis;   // [polynom][parameter][a, b, c]
+    std::vector<size_t> _support;  // per polynom: number of leading parameters with basis != 0
+    bool _support_dirty{true};
+    std::vector<value_t> _gram;    // lower triangle of G, row major
+    std::vector<value_t> _rhs;     // h
+    std::vector<value_t> _row;     // scratch of add()
+    size_t _samples{0};
+
+    // Constructors
+public:
+    /**
+     * @brief   Create new instance with zero offset and basis.
+     *
+     * @param   knot_x      The x-knots (num_knots values).
+     * @param   num_knots   The number of knots.
+     * @param   num_params  The number of parameters.
+     */
+    SplineFitter(const value_t * knot_x, size_t num_knots, size_t num_params)
+        : _knot_x(knot_x, knot_x + num_knots), _params{num_params},
+          _offset(3 * (num_knots - 1), 0), _basis(3 * (num_knots - 1) * num_params, 0),
+          _support(num_knots - 1, num_params), _gram(num_params * num_params, 0),
+          _rhs(num_params, 0), _row(num_params)
+    {}
+
+    // Properties
+public:
+    size_t numParams() const noexcept { return _params; }
+
+    size_t samples() const noexcept { return _samples; }
+
+    /**
+     * @brief   Sets the polynom coefficients of the fixed part.
+     */
+    void offset(const value_t * polynom)
+    {
+        std::copy(polynom, polynom + _offset.size(), _offset.begin());
+    }
+
+    /**
+     * @brief   Sets the polynom coefficients of basis function j.
+     */
+    void basis(size_t j, const value_t * polynom)
+    {
+        for (size_t i = 0; i < _knot_x.size() - 1; ++i)
+            std::copy(polynom + 3 * i, polynom + 3 * i + 3, _basis.begin() + 3 * (i * _params + j));
+        _support_dirty = true;
+    }
+
+    // Methods
+private:
+    void updateSupport()
+    {
+        _support_dirty = false;
+        for (size_t i = 0; i < _support.size(); ++i)
+        {
+            const value_t * b{_basis.data() + 3 * i * _params};
+            size_t k{_params};
+            while (k && b[3 * k - 3] == 0 && b[3 * k - 2] == 0 && b[3 * k - 1] == 0) --k;
+            _support[i] = k;
+        }
+    }
+
+public:
+    /**
+     * @brief   Drops all samples.
+     */
+    void clear()
+    {
+        std::fill(_gram.begin(), _gram.end(), value_t(0));
+        std::fill(_rhs.begin(), _rhs.end(), value_t(0));
+        _samples = 0;
+    }
+
+    /**
+     * @brief   Adds a sample to the normal equations.
+     *
+     * @param   x       The x-value.
+     * @param   y       The value the spline should have at x.
+     * @param   weight  The weight of the squared residual.
+     */
+    void add(value_t x, value_t y, value_t weight = 1)
+    {
+        if (_support_dirty) updateSupport();
+
+        size_t n{_knot_x.size()};
+        size_t i(std::upper_bound(_knot_x.begin(), _knot_x.end(), x) - _knot_x.begin());
+        i = std::min(std::max(i, size_t(1)), n - 1) - 1;
+        x = std::min(x, _knot_x[n - 1]); // the spline is constant behind the intervall
+
+        auto eval = [x](const value_t * p) { return (p[0] * x + p[1]) * x + p[2]; };
+
+        const value_t * b{_basis.data() + 3 * i * _params};
+        size_t m{_support[i]};
+        for (size_t j = 0; j < m; ++j) _row[j] = eval(b + 3 * j);
+
+        value_t r{y - eval(_offset.data() + 3 * i)};
+        for (size_t j = 0; j < m; ++j)
+        {
+            value_t wj{weight * _row[j]};
+            if (wj == 0) continue;
+            _rhs[j] += wj * r;
+            value_t * g{_gram.data() + j * _params};
+            for (size_t k = 0; k <= j; ++k) g[k] += wj * _row[k];
+        }
+        _samples++;
+    }
+
+    /**
+     * @brief   Adds n samples, see add(value_t, value_t, value_t).
+     *
+     * @param   xs      Pointer to n x-values.
+     * @param   ys      Pointer to n y-values.
+     * @param   n       The number of samples.
+     * @param   weights Pointer to n weights or nullptr for 1.
+     */
+    void add(const value_t * xs, const value_t * ys, size_t n, const value_t * weights = nullptr)
+    {
+        for (size_t s = 0; s < n; ++s) add(xs[s], ys[s], weights ? weights[s] : value_t(1));
+    }
+
+    /**
+     * @brief   Solves (G + lambda I) p = h.
+     *
+     * @param   lambda  Ridge regularization, pulls the parameters towards 0.
+     *
+     * @return The parameters.
+     * @throws std::runtime_error if the system is singular (too few samples, no regularization).
+     */
+    std::vector<value_t> solve(value_t lambda = 0) const
+    {
+        size_t n{_params};
+        std::vector<value_t> L(_gram), p(_rhs);
+        for (size_t j = 0; j < n; ++j) L[j * n + j] += lambda;
+
+        // cholesky, G = L L^T
+        for (size_t j = 0; j < n; ++j)
+        {
+            value_t * lj{L.data() + j * n};
+            for (size_t k = 0; k < j; ++k)
+            {
+                const value_t * lk{L.data() + k * n};
+                value_t s{lj[k]};
+                for (size_t m = 0; m < k; ++m) s -= lj[m] * lk[m];
+                lj[k] = s / lk[k];
+            }
+            value_t d{lj[j]};
+            for (size_t m = 0; m < j; ++m) d -= lj[m] * lj[m];
+            if (!(d > 0))
+                throw std::runtime_error("SplineFitter: normal equations are singular.");
+            lj[j] = std::sqrt(d);
+        }
+
+        for (size_t j = 0; j < n; ++j) // L y = h
+        {
+            for (size_t m = 0; m < j; ++m) p[j] -= L[j * n + m] * p[m];
+            p[j] /= L[j * n + j];
+        }
+        for (size_t j = n; j-- > 0;) // L^T p = y
+        {
+            for (size_t m = j + 1; m < n; ++m) p[j] -= L[m * n + j] * p[m];
+            p[j] /= L[j * n + j];
+        }
+        return p;
+    }
+
+    /**
+     * @brief   Fits the parameters of a spline which are set by set(s, j, v) on a copy of spline:
+     *          sets up offset and basis with one generation per parameter, streams the samples
+     *          and solves.
+     *
+     * @return The parameters.
+     */
+    template <typename spline_t, typename set_t>
+    static std::vector<value_t> fitParameters(const spline_t & spline, size_t num_params,
+                                              set_t set, const value_t * xs, const value_t * ys,
+                                              size_t n, const value_t * weights, value_t lambda)
+    {
+        spline_t s{spline};
+        size_t m{3 * (s.numKnots() - 1)};
+        SplineFitter<value_t> fitter(s.knotXData(), s.numKnots(), num_params);
+
+        for (size_t j = 0; j < num_params; ++j) set(s, j, value_t(0));
+        s.generate();
+        std::vector<value_t> offset(s.polynomData(), s.polynomData() + m), unit(m);
+        fitter.offset(offset.data());
+
+        for (size_t j = 0; j < num_params; ++j)
+        {
+            set(s, j, value_t(1));
+            s.generate();
+            for (size_t k = 0; k < m; ++k) unit[k] = s.polynomData()[k] - offset[k];
+            fitter.basis(j, unit.data());
+            set(s, j, value_t(0));
+        }
+
+        fitter.add(xs, ys, n, weights);
+        return fitter.solve(lambda);
+    }
+};
+
+/**
+ * @brief   Fits the y-knots of spline to the samples (weighted least squares, see
+ *          @ref SplineFitter) and generates it. The x-knots are kept.
+ *
+ * @param   spline  The spline, is modified.
+ * @param   xs      Pointer to n x-values.
+ * @param   ys      Pointer to n y-values.
+ * @param   n       The number of samples.
+ * @param   weights Pointer to n weights or nullptr for 1.
+ * @param   lambda  Ridge regularization of the knots.
+ *
+ * @ingroup Math
+ */
+template <typename value_t>
+void fit(QuadraticSpline<value_t> & spline, const value_t * xs, const value_t * ys, size_t n,
+         const value_t * weights = nullptr, value_t lambda = 0)
+{
+    auto set = [](QuadraticSpline<value_t> & s, size_t j, value_t v) { s.specify(j, v); };
+    auto p = SplineFitter<value_t>::fitParameters(spline, spline.numKnots(), set, xs, ys, n,
+                                                  weights, lambda);
+    for (size_t j = 0; j < p.size(); ++j) set(spline, j, p[j]);
+    spline.generate();
+}
+
+/**
+ * @brief   Fits the gradients of spline to the samples, y_0 (and y_n) stay fixed. See
+ *          fit(QuadraticSpline<value_t> &, ...).
+ *
+ * @ingroup Math
+ */
+template <typename value_t>
+void fit(GradientSpline<value_t> & spline, const value_t * xs, const value_t * ys, size_t n,
+         const value_t * weights = nullptr, value_t lambda = 0)
+{
+    auto set = [](GradientSpline<value_t> & s, size_t j, value_t v) { s.specify(j + 1, v); };
+    auto p = SplineFitter<value_t>::fitParameters(spline, spline.numGradients(), set, xs, ys, n,
+                                                  weights, lambda);
+    for (size_t j = 0; j < p.size(); ++j) set(spline, j, p[j]);
+    spline.generate();
+}
+
+/**
+ * @brief   Fits the curvatures of spline to the samples, y_0 and y_n stay fixed. See
+ *          fit(QuadraticSpline<value_t> &, ...).
+ *
+ * The spline is linear in g_j = alpha a_j under the constraint f(end) = y_n, which is used to
+ * eliminate the last g. The curvatures are set to g, so alpha becomes 1. Requires y_0 != y_n
+ * (otherwise every CurvatureSpline is constant).
+ *
+ * @ingroup Math
+ */
+template <typename value_t>
+void fit(CurvatureSpline<value_t> & spline, const value_t * xs, const value_t * ys, size_t n,
+         const value_t * weights = nullptr, value_t lambda = 0)
+{
+    size_t num_a{spline.numCurvatures()}, m{3 * num_a}, last{num_a - 1};
+    const auto & x{spline.X()};
+    value_t y_0{spline.y0()}, r{spline.yN() - y_0};
+    if (r == 0) throw std::runtime_error("SplineFitter: curvature spline with y_0 == y_n.");
+
+    // psi_j: spline of curvature e_j with alpha = 1, e_j = psi_j(end)
+    CurvatureSpline<value_t> s{spline};
+    std::vector<value_t> psi(m * num_a), e(num_a);
+    for (size_t j = 0; j < num_a; ++j)
+    {
+        for (size_t k = 0; k < num_a; ++k) s.curvature(k, value_t(k == j));
+        s.generate();
+        value_t alpha{s.polynomData()[3 * j]};
+        for (size_t k = 0; k < m; ++k)
+            psi[j * m + k] = (s.polynomData()[k] - value_t(k % 3 == 2) * y_0) / alpha;
+        e[j] = r / alpha;
+    }
+
+    // f = y_0 + r / e_last psi_last + sum_{j < last} g_j (psi_j - e_j / e_last psi_last)
+    SplineFitter<value_t> fitter(x.data(), x.size(), last);
+    std::vector<value_t> p(m);
+    for (size_t k = 0; k < m; ++k)
+        p[k] = value_t(k % 3 == 2) * y_0 + r / e[last] * psi[last * m + k];
+    fitter.offset(p.data());
+    for (size_t j = 0; j < last; ++j)
+    {
+        for (size_t k = 0; k < m; ++k)
+            p[k] = psi[j * m + k] - e[j] / e[last] * psi[last * m + k];
+        fitter.basis(j, p.data());
+    }
+
+    fitter.add(xs, ys, n, weights);
+    std::vector<value_t> g{last ? fitter.solve(lambda) : std::vector<value_t>()};
+
+    value_t g_last{r};
+    for (size_t j = 0; j < last; ++j)
+    {
+        spline.curvature(j, g[j]);
+        g_last -= g[j] * e[j];
+    }
+    spline.curvature(last, g_last / e[last]);
+    spline.generate();
+}
+
+} // namespace My::Math
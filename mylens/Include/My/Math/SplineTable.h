@@ -0,0 +1,169 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "Math/SIMD.h"
+
+namespace My::Math
+{
+
+/**
+ * @brief   Dense uniform lookup table of a quadratic spline with linear interpolation between
+ *          the samples. Evaluation is one multiply, one floor and two loads.
+ *
+ * The number of cells is chosen from the polynom coefficients, so that the interpolation error
+ * stays below the requested bound on the whole intervall (up to rounding). For a cell of width h
+ * the error of linear interpolation is at most
+ *
+ *      h^2 / 4 * max|a_i| + h / 4 * sum|jump of f'| + sum|jump of f|
+ *
+ * where the jumps are taken at the inner knots (they are zero for C1 splines, but e.g. the last
+ * polynom of a GradientSpline with y_n is only C0). Outside of the intervall the table is
+ * clamped to the first and last sample.
+ *
+ * @tparam  value_t     The floating point type to operate on.
+ *
+ * @ingroup Math
+ * @author  Ronja Schnur (rschnur@students.uni-mainz.de)
+ */
+template <typename value_t> class SplineTable
+{
+    // Data
+private:
+    std::vector<value_t> _values; // cells + 2 samples, the last one repeated
+    value_t _start{0}, _scale{0};
+    size_t _cells{0};
+    value_t _error{0};
+
+public:
+    static constexpr size_t max_cells = size_t(1) << 24;
+
+    // Properties
+public:
+    bool empty() const noexcept { return _cells == 0; }
+
+    size_t cells() const noexcept { return _cells; }
+
+    /**
+     * @brief   The guaranteed maximum absolute error of the table. It is larger than requested
+     *          only if max_cells did not suffice (or f has jumps larger than the request).
+     */
+    value_t error() const noexcept { return _error; }
+
+    /**
+     * @brief   Memory used by the table in bytes.
+     */
+    size_t memory() const noexcept { return sizeof(*this) + _values.capacity() * sizeof(value_t); }
+
+    // Methods
+public:
+    /**
+     * @brief   Samples the spline given by its knots and polynom coefficients.
+     *
+     * @param   knot_x      The x-knots (num_knots values).
+     * @param   polynom     The polynom coefficients (3 * (num_knots - 1) values).
+     * @param   num_knots   The number of knots.
+     * @param   max_error   The maximum absolute error against the polynoms.
+     */
+    void build(const value_t * knot_x, const value_t * polynom, size_t num_knots, value_t max_error)
+    {
+        auto p = [polynom](size_t i, value_t x) {
+            return (polynom[3 * i] * x + polynom[3 * i + 1]) * x + polynom[3 * i + 2];
+        };
+        auto dp = [polynom](size_t i, value_t x) {
+            return 2 * polynom[3 * i] * x + polynom[3 * i + 1];
+        };
+
+        using std::abs, std::sqrt; // or the overloads of value_t (see @ref Dual)
+
+        value_t A{0}, J1{0}, J0{0};
+        for (size_t i = 0; i < num_knots - 1; ++i)
+        {
+            A = std::max(A, value_t(abs(polynom[3 * i])));
+            if (i == 0) continue;
+            J1 += abs(dp(i, knot_x[i]) - dp(i - 1, knot_x[i]));
+            J0 += abs(p(i, knot_x[i]) - p(i - 1, knot_x[i]));
+        }
+
+        // largest h with A / 4 h^2 + J1 / 4 h <= max_error - J0
+        value_t length{knot_x[num_knots - 1] - knot_x[0]}, r{max_error - J0}, h{length};
+        if (!(r > 0))
+            h = 0;
+        else if (A > 0)
+            h = (sqrt(J1 * J1 / 16 + A * r) - J1 / 4) / (A / 2);
+        else if (J1 > 0)
+            h = 4 * r / J1;
+
+        double cells = h > 0 ? std::ceil(double(length / h)) : double(max_cells);
+        _cells = size_t(std::min(std::max(cells, 1.0), double(max_cells)));
+        h = length / value_t(_cells);
+        _error = A * h * h / 4 + J1 * h / 4 + J0;
+
+        _start = knot_x[0];
+        _scale = value_t(_cells) / length;
+        _values.resize(_cells + 2);
+
+        size_t s{0};
+        for (size_t j = 0; j <= _cells; ++j)
+        {
+            value_t x{j == _cells ? knot_x[num_knots - 1] : _start + value_t(j) * h};
+            while (s < num_knots - 2 && !(x < knot_x[s + 1])) ++s;
+            _values[j] = p(s, x);
+        }
+        _values[_cells + 1] = _values[_cells];
+    }
+
+    /**
+     * @brief   Drops the table.
+     */
+    void clear()
+    {
+        _values = std::vector<value_t>();
+        _cells = 0;
+        _error = 0;
+    }
+
+    value_t operator()(value_t x) const
+    {
+        value_t t{(x - _start) * _scale};
+        t = !(t > 0) ? value_t(0) : std::min(t, value_t(_cells)); // NaN to 0 as well
+        size_t i{size_t(t)};
+        value_t f{t - value_t(i)};
+        return _values[i] + f * (_values[i + 1] - _values[i]);
+    }
+
+    /**
+     * @brief   Evaluates the table at n positions at once, see @ref Batch.
+     *
+     * @param   xs      Pointer to n x-values.
+     * @param   out     Pointer to n results.
+     * @param   n       The number of values.
+     */
+    void compute(const value_t * xs, value_t * out, size_t n) const
+    {
+        using batch_t = Batch<value_t>;
+        constexpr size_t W = batch_t::width;
+
+        const batch_t start{batch_t::broadcast(_start)}, scale{batch_t::broadcast(_scale)};
+        const batch_t zero{batch_t::broadcast(0)}, last{batch_t::broadcast(value_t(_cells))};
+        const value_t * v{_values.data()};
+        int32_t id[W];
+
+        size_t full{n - n % W};
+        for (size_t i = 0; i < full; i += W)
+        {
+            batch_t t{(batch_t::load(xs + i) - start) * scale};
+            t = batch_t::max(batch_t::min(t, last), zero);
+            batch_t::indices(t, int32_t(_cells), 1, id);
+            batch_t a{batch_t::gather(v, id)};
+            for (size_t k = 0; k < W; ++k) id[k] += 1;
+            batch_t b{batch_t::gather(v, id)};
+            (a + (t - batch_t::truncate(t)) * (b - a)).store(out + i);
+        }
+        for (size_t j = full; j < n; ++j) out[j] = (*this)(xs[j]);
+    }
+};
+
+} // namespace My::Math
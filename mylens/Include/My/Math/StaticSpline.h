@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+
+#include "Math/QuadraticSpline.h"
+
+namespace My::Math
+{
+
+/**
+ * @brief   Statically dispatched (CRTP) spline interface.
+ *
+ * Counterpart of @ref Spline for code that knows the spline type at compile time. derived_t has
+ * to provide <code>value_t evaluate(value_t) const</code> and
+ * <code>value_t evaluateDerivative(value_t) const</code>; all calls resolve at compile time and
+ * can be inlined into (and vectorized with) the calling loop.
+ *
+ * @tparam  derived_t   The implementing class.
+ * @tparam  value_t     The floating point type to operate on.
+ *
+ * @ingroup Math
+ * @author  Ronja Schnur (rschnur@students.uni-mainz.de)
+ */
+template <typename derived_t, typename value_t> class StaticSpline
+{
+    // Methods
+protected:
+    constexpr const derived_t & self() const { return static_cast<const derived_t &>(*this); }
+
+public:
+    /**
+     * @brief   Computes the spline at value.
+     */
+    constexpr value_t operator()(value_t value) const { return self().evaluate(value); }
+
+    /**
+     * @brief   Computes the spline at n positions.
+     *
+     * @param   xs      Pointer to n x-values.
+     * @param   out     Pointer to n results.
+     * @param   n       The number of values.
+     */
+    constexpr void operator()(const value_t * xs, value_t * out, size_t n) const
+    {
+        for (size_t i = 0; i < n; ++i) out[i] = self().evaluate(xs[i]);
+    }
+
+    /**
+     * @brief   Computes the derivative of the spline at value.
+     */
+    constexpr value_t derivative(value_t value) const { return self().evaluateDerivative(value); }
+
+    /**
+     * @brief   Computes the derivative of the spline at n positions.
+     */
+    constexpr void derivative(const value_t * xs, value_t * out, size_t n) const
+    {
+        for (size_t i = 0; i < n; ++i) out[i] = self().evaluateDerivative(xs[i]);
+    }
+};
+
+/**
+ * @brief   Static view on a @ref QuadraticSpline (and therefore also @ref CurvatureSpline and
+ *          @ref GradientSpline, which share its evaluation). It holds a reference only, the
+ *          spline has to outlive it and must be generated.
+ *
+ *      GradientSpline<float> spline(...);
+ *      spline.generate();
+ *      auto f = staticSpline(spline);
+ *      for (size_t i = 0; i < n; ++i) out[i] = f(xs[i]); // inlined, no virtual call
+ *
+ * @tparam  value_t     The floating point type to operate on.
+ *
+ * @ingroup Math
+ * @author  Ronja Schnur (rschnur@students.uni-mainz.de)
+ */
+template <typename value_t>
+class StaticQuadraticSpline : public StaticSpline<StaticQuadraticSpline<value_t>, value_t>
+{
+    // Data
+private:
+    const QuadraticSpline<value_t> & _spline;
+
+    // Constructors
+public:
+    StaticQuadraticSpline(const QuadraticSpline<value_t> & spline) : _spline{spline} {}
+
+    // Methods
+public:
+    value_t evaluate(value_t value) const { return _spline.evaluate(value); }
+
+    value_t evaluateDerivative(value_t value) const { return _spline.evaluateDerivative(value); }
+};
+
+/**
+ * @brief   Creates a @ref StaticQuadraticSpline for spline.
+ */
+template <typename value_t>
+StaticQuadraticSpline<value_t> staticSpline(const QuadraticSpline<value_t> & spline)
+{
+    return StaticQuadraticSpline<value_t>(spline);
+}
+
+} // namespace My::Math
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+
+#include "Math/SIMD.h"
+
+namespace My::Math
+{
+
+/**
+ * @brief   Solves count independent tridiagonal systems of n equations with the Thomas algorithm
+ *          (no pivoting, so the matrices should be diagonally dominant, as spline systems are).
+ *
+ * All arrays are interleaved: row k of system s is stored at [k * count + s], so the systems
+ * are solved side by side in the lanes of one SIMD register (see @ref Batch). Row k reads
+ *
+ *      lower[k] x[k - 1] + diag[k] x[k] + upper[k] x[k + 1] = rhs[k]
+ *
+ * where lower[0] and upper[n - 1] are ignored.
+ *
+ * @param   lower       Sub-diagonal, n * count values.
+ * @param   diag        Diagonal, n * count values.
+ * @param   upper       Super-diagonal, n * count values.
+ * @param   rhs         Right hand side, n * count values, is overwritten by the solution.
+ * @param   n           The number of equations of each system.
+ * @param   count       The number of systems.
+ * @param   scratch     n * count values of temporary storage.
+ *
+ * @ingroup Math
+ */
+template <typename value_t>
+void solveTridiagonal(const value_t * lower, const value_t * diag, const value_t * upper,
+                      value_t * rhs, size_t n, size_t count, value_t * scratch)
+{
+    using batch_t = Batch<value_t>;
+    constexpr size_t W = batch_t::width;
+    if (n == 0) return;
+
+    size_t s{0};
+    for (; s + W <= count; s += W)
+    {
+        auto at = [count, s](size_t k) { return k * count + s; };
+
+        batch_t c{batch_t::load(upper + at(0)) / batch_t::load(diag + at(0))};
+        batch_t d{batch_t::load(rhs + at(0)) / batch_t::load(diag + at(0))};
+        c.store(scratch + at(0));
+        d.store(rhs + at(0));
+
+        for (size_t k = 1; k < n; ++k) // forward elimination
+        {
+            batch_t a{batch_t::load(lower + at(k))};
+            batch_t m{batch_t::load(diag + at(k)) - a * c};
+            c = batch_t::load(upper + at(k)) / m;
+            d = (batch_t::load(rhs + at(k)) - a * d) / m;
+            c.store(scratch + at(k));
+            d.store(rhs + at(k));
+        }
+
+        for (size_t k = n - 1; k-- > 0;) // back substitution
+        {
+            d = batch_t::load(rhs + at(k)) - batch_t::load(scratch + at(k)) * d;
+            d.store(rhs + at(k));
+        }
+    }
+
+    for (; s < count; ++s) // remaining systems
+    {
+        auto at = [count, s](size_t k) { return k * count + s; };
+
+        scratch[at(0)] = upper[at(0)] / diag[at(0)];
+        rhs[at(0)] = rhs[at(0)] / diag[at(0)];
+
+        for (size_t k = 1; k < n; ++k)
+        {
+            value_t m{diag[at(k)] - lower[at(k)] * scratch[at(k - 1)]};
+            scratch[at(k)] = upper[at(k)] / m;
+            rhs[at(k)] = (rhs[at(k)] - lower[at(k)] * rhs[at(k - 1)]) / m;
+        }
+
+        for (size_t k = n - 1; k-- > 0;) rhs[at(k)] -= scratch[at(k)] * rhs[at(k + 1)];
+    }
+}
+
+} // namespace My::Math
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace My::Utility
+{
+
+/**
+ * @brief   Read-only memory mapping of a whole file (mmap on POSIX, file mapping on Windows,
+ *          using the *FromApp functions which are also available to UWP apps).
+ *
+ * @ingroup Utility
+ * @author  Ronja Schnur (rschnur@students.uni-mainz.de)
+ */
+class MappedFile
+{
+    // Data
+private:
+    const void * _data{nullptr};
+    size_t _size{0};
+#ifdef _WIN32
+    HANDLE _file{INVALID_HANDLE_VALUE}, _mapping{nullptr};
+#endif
+
+    // Constructors
+public:
+    /**
+     * @brief   Maps the file at path.
+     *
+     * @throws  std::runtime_error if it cannot be opened or mapped.
+     */
+    explicit MappedFile(const std::filesystem::path & path)
+    {
+#ifdef _WIN32
+        _file = CreateFile2(path.c_str(), GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, nullptr);
+        LARGE_INTEGER size;
+        if (_file == INVALID_HANDLE_VALUE || !GetFileSizeEx(_file, &size))
+        {
+            close();
+            throw std::runtime_error("Utility: Could not open file.");
+        }
+        _size = size_t(size.QuadPart);
+        if (_size == 0) return;
+
+        _mapping = CreateFileMappingFromApp(_file, nullptr, PAGE_READONLY, 0, nullptr);
+        _data = _mapping ? MapViewOfFileFromApp(_mapping, FILE_MAP_READ, 0, 0) : nullptr;
+        if (!_data)
+        {
+            close();
+            throw std::runtime_error("Utility: Could not map file.");
+        }
+#else
+        int file{::open(path.c_str(), O_RDONLY)};
+        struct stat info;
+        if (file < 0 || fstat(file, &info) != 0)
+        {
+            if (file >= 0) ::close(file);
+            throw std::runtime_error("Utility: Could not open file.");
+        }
+        _size = size_t(info.st_size);
+        if (_size == 0)
+        {
+            ::close(file);
+            return;
+        }
+
+        void * data{mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, file, 0)};
+        ::close(file); // the mapping keeps its own reference
+        if (data == MAP_FAILED)
+        {
+            _size = 0;
+            throw std::runtime_error("Utility: Could not map file.");
+        }
+        _data = data;
+#endif
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile & operator=(const MappedFile &) = delete;
+
+    MappedFile(MappedFile && o) noexcept { *this = std::move(o); }
+
+    MappedFile & operator=(MappedFile && o) noexcept
+    {
+        if (this == &o) return *this;
+        close();
+        std::swap(_data, o._data);
+        std::swap(_size, o._size);
+#ifdef _WIN32
+        std::swap(_file, o._file);
+        std::swap(_mapping, o._mapping);
+#endif
+        return *this;
+    }
+
+    ~MappedFile() { close(); }
+
+    // Properties
+public:
+    const void * data() const noexcept { return _data; }
+
+    size_t size() const noexcept { return _size; }
+
+    // Methods
+private:
+    void close() noexcept
+    {
+#ifdef _WIN32
+        if (_data) UnmapViewOfFile(_data);
+        if (_mapping) CloseHandle(_mapping);
+        if (_file != INVALID_HANDLE_VALUE) CloseHandle(_file);
+        _mapping = nullptr;
+        _file = INVALID_HANDLE_VALUE;
+#else
+        if (_data) munmap(const_cast<void *>(_data), _size);
+#endif
+        _data = nullptr;
+        _size = 0;
+    }
+};
+
+} // namespace My::Utility